@@ -1,23 +1,24 @@
 #include "client.h"
+#include "tracer.h"
 #include <QVBoxLayout>
 #include <QMessageBox>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QJsonParseError>
 #include <QDebug>
 #include <QTimer>
 #include <QEventLoop>
 #include <QCoreApplication>
+#include <QUrl>
 
 // Инициализация статических констант
 const QString Client::DEFAULT_SERVER_ADDRESS = "localhost";
 const int Client::DEFAULT_SERVER_PORT;  // Уже инициализирован в заголовочном файле
 const int Client::RECONNECT_TIMEOUT_MS;  // Уже инициализирован в заголовочном файле
 const int Client::CONSOLE_TIMEOUT_MS;  // Уже инициализирован в заголовочном файле
+const int Client::MIN_RETRY_DELAY_MS;  // Уже инициализирован в заголовочном файле
+const int Client::PREFETCH_NEIGHBOURS;  // Уже инициализирован в заголовочном файле
 
 Client::Client(bool consoleMode, QWidget *parent) : QMainWindow(parent), 
-    consoleOut(stdout), isConsoleMode(consoleMode), dataReceived(false)
+    consoleOut(stdout), isConsoleMode(consoleMode), dataReceived(false),
+    requestFailed(false)
 {
     serverAddress = DEFAULT_SERVER_ADDRESS;
     serverPort = DEFAULT_SERVER_PORT;
@@ -29,6 +30,21 @@ Client::Client(bool consoleMode, QWidget *parent) : QMainWindow(parent),
     connect(socket, &QTcpSocket::readyRead, this, &Client::handleReadyRead);
     connect(socket, &QTcpSocket::errorOccurred, this, &Client::handleError);
 
+    localSocket = new QLocalSocket(this);
+    
+    connect(localSocket, &QLocalSocket::connected, this, &Client::handleConnected);
+    connect(localSocket, &QLocalSocket::disconnected, this, &Client::handleDisconnected);
+    connect(localSocket, &QLocalSocket::readyRead, this, &Client::handleReadyRead);
+    connect(localSocket, &QLocalSocket::errorOccurred, this, &Client::handleLocalError);
+
+    jsonParser = new JsonStreamParser(this);
+
+    connect(jsonParser, &JsonStreamParser::arrayStarted, this, &Client::handleArrayStarted);
+    connect(jsonParser, &JsonStreamParser::rowsReady, this, &Client::handleRowsReady);
+    connect(jsonParser, &JsonStreamParser::arrayFinished, this, &Client::handleArrayFinished);
+    connect(jsonParser, &JsonStreamParser::parseError, this, &Client::handleParseError);
+    connect(jsonParser, &JsonStreamParser::objectReady, this, &Client::handleObjectReady);
+
     if (!isConsoleMode) {
         setupUi();
     }
@@ -38,8 +54,8 @@ Client::~Client()
 {
     // Ресурсы, принадлежащие QObject, будут освобождены автоматически
     // благодаря системе родительских объектов Qt
-    if (socket->state() == QAbstractSocket::ConnectedState) {
-        socket->disconnectFromHost();
+    if (isConnected()) {
+        disconnectFromServer();
     }
 }
 
@@ -53,8 +69,8 @@ void Client::setServerAddress(const QString &address)
     if (serverAddress != address) {
         serverAddress = address;
         // Если сокет подключен, переподключаемся с новыми параметрами
-        if (socket->state() == QAbstractSocket::ConnectedState) {
-            socket->disconnectFromHost();
+        if (isConnected()) {
+            disconnectFromServer();
             connectToServer();
         }
     }
@@ -70,15 +86,72 @@ void Client::setServerPort(int port)
     if (serverPort != port && port > 0 && port < 65536) {
         serverPort = port;
         // Если сокет подключен, переподключаемся с новыми параметрами
-        if (socket->state() == QAbstractSocket::ConnectedState) {
-            socket->disconnectFromHost();
+        if (isConnected()) {
+            disconnectFromServer();
             connectToServer();
         }
     }
 }
 
+QString Client::getLocalServerName() const
+{
+    return localServerName;
+}
+
+void Client::setLocalServerName(const QString &name)
+{
+    if (localServerName != name) {
+        // Разрываем соединение прежнего транспорта до смены режима
+        bool wasConnected = isConnected();
+        if (wasConnected) {
+            disconnectFromServer();
+        }
+        localServerName = name;
+        if (wasConnected) {
+            connectToServer();
+        }
+    }
+}
+
+QIODevice *Client::connection() const
+{
+    if (!localServerName.isEmpty()) {
+        return localSocket;
+    }
+    return socket;
+}
+
+bool Client::isConnected() const
+{
+    if (!localServerName.isEmpty()) {
+        return localSocket->state() == QLocalSocket::ConnectedState;
+    }
+    return socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void Client::disconnectFromServer()
+{
+    if (!localServerName.isEmpty()) {
+        localSocket->disconnectFromServer();
+    } else {
+        socket->disconnectFromHost();
+    }
+}
+
+QString Client::serverDescription() const
+{
+    if (!localServerName.isEmpty()) {
+        return "local:" + localServerName;
+    }
+    return serverAddress + ":" + QString::number(serverPort);
+}
+
 bool Client::parseCommandLineArgs(const QCommandLineParser &parser)
 {
+    if (parser.isSet("local")) {
+        setLocalServerName(parser.value("local"));
+    }
+    
     if (parser.isSet("address")) {
         setServerAddress(parser.value("address"));
     }
@@ -104,7 +177,7 @@ bool Client::parseCommandLineArgs(const QCommandLineParser &parser)
 int Client::runConsoleMode()
 {
     consoleOut << "Запуск в консольном режиме" << Qt::endl;
-    consoleOut << "Подключение к " << serverAddress << ":" << serverPort << "..." << Qt::endl;
+    consoleOut << "Подключение к " << serverDescription() << "..." << Qt::endl;
     
     connectToServer();
     
@@ -115,11 +188,17 @@ int Client::runConsoleMode()
     // Соединяем сигналы с выходом из цикла событий
     connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
     connect(socket, &QTcpSocket::disconnected, &loop, &QEventLoop::quit);
-    connect(this, &Client::handleConsoleDataReceived, &loop, &QEventLoop::quit);
+    connect(localSocket, &QLocalSocket::disconnected, &loop, &QEventLoop::quit);
+    connect(this, &Client::consoleFinished, &loop, &QEventLoop::quit);
     
     timer.start(CONSOLE_TIMEOUT_MS);
     loop.exec();
     
+    // Сообщение об ошибке уже выведено в handleParseError() или handleServerError()
+    if (requestFailed) {
+        return 1;
+    }
+    
     if (!dataReceived) {
         consoleOut << "Ошибка: Таймаут при ожидании данных от сервера." << Qt::endl;
         return 1;
@@ -138,10 +217,13 @@ void Client::setupUi()
     treeWidget = new QTreeWidget(this);
     treeWidget->setHeaderLabels({"IP", "Имя", "Описание"});
     treeWidget->setAlternatingRowColors(true);
-    treeWidget->setRootIsDecorated(false);
+    treeWidget->setRootIsDecorated(true);
     treeWidget->setUniformRowHeights(true);
     treeWidget->setSortingEnabled(true);
     
+    // Платы и порты загружаются только при раскрытии узла
+    connect(treeWidget, &QTreeWidget::itemExpanded, this, &Client::handleItemExpanded);
+    
     statusLabel = new QLabel("Статус подключения: Отключено", this);
     
     layout->addWidget(treeWidget);
@@ -156,7 +238,7 @@ void Client::setupUi()
 
 void Client::connectToServer()
 {
-    if (socket->state() == QAbstractSocket::ConnectedState) {
+    if (isConnected()) {
         return; // Уже подключены
     }
     
@@ -166,19 +248,29 @@ void Client::connectToServer()
         consoleOut << "Подключение к серверу..." << Qt::endl;
     }
     
-    socket->connectToHost(serverAddress, serverPort);
+    if (!localServerName.isEmpty()) {
+        localSocket->connectToServer(localServerName);
+    } else {
+        socket->connectToHost(serverAddress, serverPort);
+    }
 }
 
 void Client::handleConnected()
 {
+    lastServerError.clear();
     if (!isConsoleMode) {
         updateConnectionStatus();
     } else {
-        consoleOut << "Подключено к серверу " << serverAddress << ":" << serverPort << Qt::endl;
+        consoleOut << "Подключено к серверу " << serverDescription() << Qt::endl;
         consoleOut << "Отправка запроса GET_DATA" << Qt::endl;
     }
     
-    socket->write("GET_DATA");
+    // Новое подключение - новый документ, остатки прежнего не нужны;
+    // ответы на запросы, отправленные по старому соединению, уже не придут
+    jsonParser->reset();
+    pendingBoards.clear();
+    pendingPorts.clear();
+    sendCommand("GET_DATA");
 }
 
 void Client::handleDisconnected()
@@ -194,7 +286,17 @@ void Client::handleDisconnected()
 
 void Client::handleError(QAbstractSocket::SocketError error)
 {
-    QString errorStr = "Ошибка подключения: " + socket->errorString();
+    reportConnectionError(socket->errorString());
+}
+
+void Client::handleLocalError(QLocalSocket::LocalSocketError error)
+{
+    reportConnectionError(localSocket->errorString());
+}
+
+void Client::reportConnectionError(const QString &errorString)
+{
+    QString errorStr = "Ошибка подключения: " + errorString;
     
     if (!isConsoleMode) {
         statusLabel->setText(errorStr);
@@ -206,14 +308,18 @@ void Client::handleError(QAbstractSocket::SocketError error)
 
 void Client::updateConnectionStatus()
 {
-    QString status = socket->state() == QAbstractSocket::ConnectedState ?
-                    "Подключено" : "Отключено";
+    QString status = isConnected() ? "Подключено" : "Отключено";
+    if (!lastServerError.isEmpty()) {
+        status += " (" + lastServerError + ")";
+    }
     statusLabel->setText("Статус подключения: " + status);
 }
 
 void Client::handleReadyRead()
 {
-    QByteArray jsonData = socket->readAll();
+    TRACE_SPAN("Client::handleReadyRead");
+    
+    QByteArray jsonData = connection()->readAll();
     
     if (jsonData.isEmpty()) {
         if (isConsoleMode) {
@@ -225,89 +331,394 @@ void Client::handleReadyRead()
     }
     
     if (!isConsoleMode) {
-        qDebug() << "Получены данные:" << jsonData;
-        processJsonData(jsonData);
+        qDebug() << "Получено байт:" << jsonData.size();
+    }
+    
+    processJsonData(jsonData);
+}
+
+void Client::processJsonData(const QByteArray &jsonData)
+{
+    TRACE_SPAN("Client::processJsonData");
+    
+    // Разбор идёт по мере поступления данных: готовые строки приходят
+    // через сигналы JsonStreamParser, не дожидаясь конца документа
+    jsonParser->feed(jsonData);
+}
+
+void Client::handleArrayStarted()
+{
+    if (!isConsoleMode) {
+        if (!lastServerError.isEmpty()) {
+            lastServerError.clear();
+            updateConnectionStatus();
+        }
+        deviceItems.clear();
+        boardItems.clear();
+        treeWidget->clear();
+        // Сортировка при каждой вставке слишком дорога, включаем её после загрузки
+        treeWidget->setSortingEnabled(false);
+    } else {
+        consoleOut << "Получение данных от сервера" << Qt::endl;
+        consoleOut << "----------------------------------------------" << Qt::endl;
+        consoleOut << QString("%1 | %2 | %3").arg("IP", -15).arg("Имя", -20).arg("Описание") << Qt::endl;
+        consoleOut << "----------------------------------------------" << Qt::endl;
+    }
+}
+
+void Client::handleRowsReady(const QList<QJsonObject> &rows)
+{
+    if (!isConsoleMode) {
+        appendRowsToTree(rows);
+    } else {
+        printRowsToConsole(rows);
+    }
+}
+
+void Client::handleArrayFinished(int rowCount)
+{
+    TRACE_SPAN("Client::handleArrayFinished");
+    
+    if (!isConsoleMode) {
+        qDebug() << "Количество элементов в массиве:" << rowCount;
+        
+        treeWidget->setSortingEnabled(true);
+        for (int i = 0; i < treeWidget->columnCount(); ++i) {
+            treeWidget->resizeColumnToContents(i);
+        }
     } else {
-        consoleOut << "Получены данные от сервера" << Qt::endl;
-        printDataToConsole(jsonData);
+        consoleOut << "----------------------------------------------" << Qt::endl;
+        consoleOut << "Получено " << rowCount << " записей" << Qt::endl;
         dataReceived = true;
-        emit handleConsoleDataReceived();
+        emit consoleFinished();
     }
 }
 
-void Client::handleConsoleDataReceived()
+void Client::handleParseError(const QString &message)
 {
-    // Этот слот вызывается, когда данные получены в консольном режиме
-    // Используется для выхода из цикла событий в runConsoleMode()
+    if (!isConsoleMode) {
+        qWarning() << "JSON parsing error:" << message;
+        treeWidget->setSortingEnabled(true);
+        // Разборщик не примет данные до сброса, а ответы на GET_BOARDS/GET_PORTS
+        // иначе терялись бы: разрываем соединение, переподключение
+        // (handleDisconnected -> handleConnected) сбросит разборщик и запросит данные заново
+        if (localServerName.isEmpty()) {
+            socket->abort();
+        } else {
+            localSocket->abort();
+        }
+    } else {
+        consoleOut << "Ошибка разбора JSON: " << message << Qt::endl;
+        // Ждать таймаута бессмысленно: разборщик не примет данные до переподключения
+        requestFailed = true;
+        emit consoleFinished();
+    }
 }
 
-void Client::processJsonData(const QByteArray &jsonData)
+void Client::appendRowsToTree(const QList<QJsonObject> &rows)
 {
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
+    TRACE_SPAN("Client::appendRowsToTree");
+    
+    QList<QTreeWidgetItem*> items;
+    items.reserve(rows.size());
+    
+    for (const QJsonObject &obj : rows) {
+        QTreeWidgetItem *item = new QTreeWidgetItem;
+        item->setText(0, obj["ip"].toString());
+        item->setText(1, obj["name"].toString());
+        item->setText(2, obj["description"].toString());
+        item->setData(0, ItemTypeRole, DeviceItem);
+        item->setData(0, IpRole, obj["ip"].toString());
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        deviceItems.insert(obj["ip"].toString(), item);
+        items.append(item);
+    }
     
-    if (parseError.error != QJsonParseError::NoError) {
-        qWarning() << "JSON parsing error:" << parseError.errorString();
+    treeWidget->addTopLevelItems(items);
+}
+
+void Client::sendCommand(const QByteArray &command)
+{
+    if (isConnected()) {
+        connection()->write(command + '\n');
+    }
+}
+
+void Client::handleItemExpanded(QTreeWidgetItem *item)
+{
+    if (item->data(0, LoadedRole).toBool()) {
         return;
     }
     
-    if (doc.isArray()) {
-        QJsonArray array = doc.array();
-        treeWidget->clear();
-        
-        qDebug() << "Количество элементов в массиве:" << array.size();
-        
-        for (const QJsonValue &value : array) {
-            QJsonObject obj = value.toObject();
+    int type = item->data(0, ItemTypeRole).toInt();
+    if (type == DeviceItem) {
+        QString ip = item->data(0, IpRole).toString();
+        if (boardCache.contains(ip)) {
+            populateBoards(item, boardCache.value(ip));
+        } else {
+            requestBoards(item);
+        }
+    } else if (type == BoardItem) {
+        QString key = boardKey(item->data(0, IpRole).toString(), item->data(0, BoardIdRole).toString());
+        if (portCache.contains(key)) {
+            populatePorts(item, portCache.value(key));
+        } else {
+            requestPorts(item);
+        }
+    }
+}
+
+void Client::requestBoards(QTreeWidgetItem *deviceItem)
+{
+    QString ip = deviceItem->data(0, IpRole).toString();
+    showLoadingPlaceholder(deviceItem);
+    
+    QByteArrayList ips;
+    if (!pendingBoards.contains(ip)) {
+        ips << encodeArgument(ip);
+        pendingBoards.insert(ip);
+    }
+    
+    // Заодно запрашиваем соседние устройства, видимые на экране:
+    // оператор, скорее всего, раскроет и их
+    const QRect viewportRect = treeWidget->viewport()->rect();
+    const int index = treeWidget->indexOfTopLevelItem(deviceItem);
+    for (int offset = 1; offset <= PREFETCH_NEIGHBOURS; ++offset) {
+        for (int neighbourIndex : {index - offset, index + offset}) {
+            QTreeWidgetItem *neighbour = treeWidget->topLevelItem(neighbourIndex);
+            if (!neighbour || !treeWidget->visualItemRect(neighbour).intersects(viewportRect)) {
+                continue;
+            }
+            QString neighbourIp = neighbour->data(0, IpRole).toString();
+            if (neighbourIp.isEmpty() || boardCache.contains(neighbourIp) ||
+                pendingBoards.contains(neighbourIp)) {
+                continue;
+            }
+            ips << encodeArgument(neighbourIp);
+            pendingBoards.insert(neighbourIp);
+        }
+    }
+    
+    if (!ips.isEmpty()) {
+        sendCommand("GET_BOARDS " + ips.join(' '));
+    }
+}
+
+void Client::requestPorts(QTreeWidgetItem *boardItem)
+{
+    QString ip = boardItem->data(0, IpRole).toString();
+    QString boardId = boardItem->data(0, BoardIdRole).toString();
+    QString key = boardKey(ip, boardId);
+    
+    showLoadingPlaceholder(boardItem);
+    
+    if (!pendingPorts.contains(key)) {
+        pendingPorts.insert(key);
+        sendCommand("GET_PORTS " + encodeArgument(ip) + ' ' + encodeArgument(boardId));
+    }
+}
+
+void Client::showLoadingPlaceholder(QTreeWidgetItem *item)
+{
+    // Заглушка могла остаться от неудачной загрузки
+    if (item->childCount() == 1 && item->child(0)->data(0, ItemTypeRole).toInt() == PlaceholderItem) {
+        item->child(0)->setText(0, "Загрузка...");
+        return;
+    }
+    if (item->childCount() > 0) {
+        return;
+    }
+    
+    QTreeWidgetItem *placeholder = new QTreeWidgetItem(item);
+    placeholder->setText(0, "Загрузка...");
+    placeholder->setData(0, ItemTypeRole, PlaceholderItem);
+    placeholder->setFlags(Qt::NoItemFlags);
+}
+
+void Client::showLoadFailed(QTreeWidgetItem *item)
+{
+    if (item->childCount() == 1 && item->child(0)->data(0, ItemTypeRole).toInt() == PlaceholderItem) {
+        item->child(0)->setText(0, "Не удалось загрузить данные");
+    }
+}
+
+QByteArray Client::encodeArgument(const QString &value)
+{
+    if (value.isEmpty()) {
+        return "-";
+    }
+    // Дефис кодируется всегда, чтобы не спутать значение "-" с пустым
+    return QUrl::toPercentEncoding(value, QByteArray(), "-");
+}
+
+void Client::handleObjectReady(const QJsonObject &object)
+{
+    QString type = object["type"].toString();
+    
+    if (type == "error") {
+        handleServerError(object);
+        return;
+    }
+    
+    if (isConsoleMode) {
+        return;
+    }
+    
+    if (type == "boards") {
+        for (const QJsonValue &value : object["devices"].toArray()) {
+            QJsonObject device = value.toObject();
+            QString ip = device["ip"].toString();
+            QJsonArray boards = device["boards"].toArray();
             
-            qDebug() << "Обработка объекта:";
-            qDebug() << "IP:" << obj["ip"].toString();
-            qDebug() << "Name:" << obj["name"].toString();
-            qDebug() << "Description:" << obj["description"].toString();
+            pendingBoards.remove(ip);
+            boardCache.insert(ip, boards);
             
-            QTreeWidgetItem *item = new QTreeWidgetItem(treeWidget);
-            item->setText(0, obj["ip"].toString());
-            item->setText(1, obj["name"].toString());
-            item->setText(2, obj["description"].toString());
+            QTreeWidgetItem *deviceItem = deviceItems.value(ip);
+            if (deviceItem && !deviceItem->data(0, LoadedRole).toBool()) {
+                populateBoards(deviceItem, boards);
+            }
         }
+    } else if (type == "ports") {
+        QString ip = object["ip"].toString();
+        QString key = boardKey(ip, object["board"].toString());
+        QJsonArray ports = object["ports"].toArray();
         
-        for (int i = 0; i < treeWidget->columnCount(); ++i) {
-            treeWidget->resizeColumnToContents(i);
+        pendingPorts.remove(key);
+        portCache.insert(key, ports);
+        
+        QTreeWidgetItem *boardItem = boardItems.value(key);
+        if (boardItem && !boardItem->data(0, LoadedRole).toBool()) {
+            populatePorts(boardItem, ports);
         }
-    } else {
-        qDebug() << "Полученные данные не являются массивом";
     }
 }
 
-void Client::printDataToConsole(const QByteArray &jsonData)
+void Client::handleServerError(const QJsonObject &object)
 {
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
+    QString message = object["message"].toString();
+    QString command = object["command"].toString();
+    QJsonArray args = object["args"].toArray();
     
-    if (parseError.error != QJsonParseError::NoError) {
-        consoleOut << "Ошибка разбора JSON: " << parseError.errorString() << Qt::endl;
+    if (isConsoleMode) {
+        consoleOut << "Ошибка сервера: " << message << Qt::endl;
+        requestFailed = true;
+        emit consoleFinished();
         return;
     }
     
-    if (doc.isArray()) {
-        QJsonArray array = doc.array();
+    qWarning() << "Ошибка сервера:" << message << command;
+    
+    // Ошибка без команды относится к подключению (например, отказ в нём)
+    if (command.isEmpty()) {
+        lastServerError = message;
+        updateConnectionStatus();
+        return;
+    }
+    
+    // Полная выгрузка отклонена ограничением частоты - повторяем,
+    // когда сервер снова её примет
+    if (command == "GET_DATA") {
+        lastServerError = message;
+        updateConnectionStatus();
+        int retryAfterMs = qMax(object["retryAfterMs"].toInt(), MIN_RETRY_DELAY_MS);
+        QTimer::singleShot(retryAfterMs, this, [this]() {
+            sendCommand("GET_DATA");
+        });
+        return;
+    }
+    
+    // Сервер возвращает аргументы отклонённого запроса, чтобы узлы
+    // не оставались в состоянии загрузки
+    if (command == "GET_BOARDS") {
+        for (const QJsonValue &value : args) {
+            QString ip = value.toString();
+            pendingBoards.remove(ip);
+            if (QTreeWidgetItem *deviceItem = deviceItems.value(ip)) {
+                showLoadFailed(deviceItem);
+            }
+        }
+    } else if (command == "GET_PORTS" && args.size() == 2) {
+        QString key = boardKey(args.at(0).toString(), args.at(1).toString());
+        pendingPorts.remove(key);
+        if (QTreeWidgetItem *boardItem = boardItems.value(key)) {
+            showLoadFailed(boardItem);
+        }
+    }
+}
+
+void Client::populateBoards(QTreeWidgetItem *deviceItem, const QJsonArray &boards)
+{
+    QString ip = deviceItem->data(0, IpRole).toString();
+    qDeleteAll(deviceItem->takeChildren());
+    
+    QList<QTreeWidgetItem*> items;
+    items.reserve(boards.size());
+    
+    for (const QJsonValue &value : boards) {
+        QJsonObject board = value.toObject();
+        QString boardId = board["id"].toString();
+        int portCount = board["portCount"].toInt();
         
-        consoleOut << "Получено " << array.size() << " записей:" << Qt::endl;
-        consoleOut << "----------------------------------------------" << Qt::endl;
-        consoleOut << QString("%1 | %2 | %3").arg("IP", -15).arg("Имя", -20).arg("Описание") << Qt::endl;
-        consoleOut << "----------------------------------------------" << Qt::endl;
+        QTreeWidgetItem *item = new QTreeWidgetItem;
+        item->setText(0, boardId);
+        item->setText(1, board["name"].toString());
+        item->setText(2, QString("Плата %1, портов: %2").arg(board["num"].toInt()).arg(portCount));
+        item->setData(0, ItemTypeRole, BoardItem);
+        item->setData(0, IpRole, ip);
+        item->setData(0, BoardIdRole, boardId);
+        item->setChildIndicatorPolicy(portCount > 0 ? QTreeWidgetItem::ShowIndicator
+                                                    : QTreeWidgetItem::DontShowIndicatorWhenChildless);
+        boardItems.insert(boardKey(ip, boardId), item);
+        items.append(item);
+    }
+    
+    deviceItem->addChildren(items);
+    deviceItem->setData(0, LoadedRole, true);
+    if (items.isEmpty()) {
+        deviceItem->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    }
+}
+
+void Client::populatePorts(QTreeWidgetItem *boardItem, const QJsonArray &ports)
+{
+    qDeleteAll(boardItem->takeChildren());
+    
+    QList<QTreeWidgetItem*> items;
+    items.reserve(ports.size());
+    
+    for (const QJsonValue &value : ports) {
+        QJsonObject port = value.toObject();
         
-        for (const QJsonValue &value : array) {
-            QJsonObject obj = value.toObject();
-            QString ip = obj["ip"].toString();
-            QString name = obj["name"].toString();
-            QString description = obj["description"].toString();
-            
-            consoleOut << QString("%1 | %2 | %3").arg(ip, -15).arg(name, -20).arg(description) << Qt::endl;
-        }
+        QTreeWidgetItem *item = new QTreeWidgetItem;
+        item->setText(0, port["id"].toString());
+        item->setText(1, QString("Порт %1").arg(port["num"].toInt()));
+        item->setText(2, QString("Среда: %1, сигнал: %2").arg(port["media"].toInt()).arg(port["signal"].toInt()));
+        item->setData(0, ItemTypeRole, PortItem);
+        items.append(item);
+    }
+    
+    boardItem->addChildren(items);
+    boardItem->setData(0, LoadedRole, true);
+    if (items.isEmpty()) {
+        boardItem->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    }
+}
+
+QString Client::boardKey(const QString &ip, const QString &boardId)
+{
+    return ip + '\n' + boardId;
+}
+
+void Client::printRowsToConsole(const QList<QJsonObject> &rows)
+{
+    for (const QJsonObject &obj : rows) {
+        QString ip = obj["ip"].toString();
+        QString name = obj["name"].toString();
+        QString description = obj["description"].toString();
         
-        consoleOut << "----------------------------------------------" << Qt::endl;
-    } else {
-        consoleOut << "Полученные данные не являются массивом" << Qt::endl;
+        consoleOut << QString("%1 | %2 | %3").arg(ip, -15).arg(name, -20).arg(description) << '\n';
     }
+    
+    // Сбрасываем буфер один раз на пачку, а не на каждую строку
+    consoleOut.flush();
 } 
\ No newline at end of file
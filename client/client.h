@@ -3,10 +3,16 @@
 
 #include <QMainWindow>
 #include <QTcpSocket>
+#include <QLocalSocket>
 #include <QTreeWidget>
 #include <QLabel>
 #include <QCommandLineParser>
 #include <QTextStream>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QSet>
+#include "jsonstreamparser.h"
 
 /**
  * @brief Класс Client представляет клиентское приложение для отображения данных с сервера
@@ -54,6 +60,18 @@ public:
      */
     void setServerPort(int port);
 
+    /**
+     * @brief Получить имя локального сокета сервера
+     * @return Имя локального сокета или пустая строка, если используется TCP
+     */
+    QString getLocalServerName() const;
+    
+    /**
+     * @brief Установить имя локального сокета сервера
+     * @param name Имя локального сокета; пустая строка - подключение по TCP
+     */
+    void setLocalServerName(const QString &name);
+
     /**
      * @brief Обработка параметров командной строки
      * @param parser Парсер командной строки
@@ -73,12 +91,24 @@ public slots:
      */
     void connectToServer();
 
+signals:
+    /**
+     * @brief Консольный режим получил ответ сервера или ошибку его разбора
+     */
+    void consoleFinished();
+
 private slots:
     void handleConnected();
     void handleDisconnected();
     void handleError(QAbstractSocket::SocketError error);
+    void handleLocalError(QLocalSocket::LocalSocketError error);
     void handleReadyRead();
-    void handleConsoleDataReceived();
+    void handleArrayStarted();
+    void handleRowsReady(const QList<QJsonObject> &rows);
+    void handleArrayFinished(int rowCount);
+    void handleParseError(const QString &message);
+    void handleObjectReady(const QJsonObject &object);
+    void handleItemExpanded(QTreeWidgetItem *item);
 
 private:
     /**
@@ -86,44 +116,186 @@ private:
      */
     void setupUi();
     
+    /**
+     * @brief Текущее соединение с сервером (TCP или локальный сокет)
+     * @return Устройство ввода-вывода активного транспорта
+     */
+    QIODevice *connection() const;
+    
+    /**
+     * @brief Проверить, установлено ли соединение с сервером
+     * @return true, если активный транспорт подключён
+     */
+    bool isConnected() const;
+    
+    /**
+     * @brief Разорвать соединение активного транспорта
+     */
+    void disconnectFromServer();
+    
+    /**
+     * @brief Описание сервера для вывода пользователю
+     * @return Адрес и порт либо имя локального сокета
+     */
+    QString serverDescription() const;
+    
+    /**
+     * @brief Показать ошибку подключения
+     * @param errorString Текст ошибки
+     */
+    void reportConnectionError(const QString &errorString);
+
     /**
      * @brief Обновление статуса подключения
      */
     void updateConnectionStatus();
     
     /**
-     * @brief Обработка полученных данных JSON
-     * @param jsonData Полученные данные в формате JSON
+     * @brief Обработка очередной порции данных JSON
+     * @param jsonData Часть данных в формате JSON, полученная из сокета
      */
     void processJsonData(const QByteArray &jsonData);
 
     /**
-     * @brief Вывод данных в консоль
-     * @param jsonData Полученные данные в формате JSON
+     * @brief Добавление строк в дерево
+     * @param rows Разобранные объекты
+     */
+    void appendRowsToTree(const QList<QJsonObject> &rows);
+
+    /**
+     * @brief Отправка команды серверу
+     * @param command Команда без завершающего перевода строки
+     */
+    void sendCommand(const QByteArray &command);
+
+    /**
+     * @brief Запрос плат устройства и видимых соседних устройств
+     * @param deviceItem Раскрытое устройство
+     */
+    void requestBoards(QTreeWidgetItem *deviceItem);
+
+    /**
+     * @brief Запрос портов платы
+     * @param boardItem Раскрытая плата
+     */
+    void requestPorts(QTreeWidgetItem *boardItem);
+
+    /**
+     * @brief Заполнение устройства платами
+     * @param deviceItem Элемент устройства
+     * @param boards Платы из ответа сервера или кэша
+     */
+    void populateBoards(QTreeWidgetItem *deviceItem, const QJsonArray &boards);
+
+    /**
+     * @brief Заполнение платы портами
+     * @param boardItem Элемент платы
+     * @param ports Порты из ответа сервера или кэша
      */
-    void printDataToConsole(const QByteArray &jsonData);
+    void populatePorts(QTreeWidgetItem *boardItem, const QJsonArray &ports);
+
+    /**
+     * @brief Показать на элементе, что его содержимое загружается
+     * @param item Раскрываемый элемент
+     */
+    void showLoadingPlaceholder(QTreeWidgetItem *item);
+
+    /**
+     * @brief Показать на элементе, что загрузка не удалась
+     *
+     * Элемент остаётся незагруженным, поэтому повторное раскрытие
+     * отправит запрос снова.
+     * @param item Элемент, ожидавший ответа
+     */
+    void showLoadFailed(QTreeWidgetItem *item);
+
+    /**
+     * @brief Обработка ответа сервера с ошибкой
+     * @param object Объект {"type":"error"} с причиной и, если есть, командой
+     */
+    void handleServerError(const QJsonObject &object);
+
+    /**
+     * @brief Кодирование аргумента команды
+     *
+     * Аргументы разделяются пробелами, поэтому кодируются процентами;
+     * пустое значение передаётся как "-".
+     * @param value Значение аргумента
+     * @return Аргумент без пробелов
+     */
+    static QByteArray encodeArgument(const QString &value);
+
+    /**
+     * @brief Ключ платы в кэше и индексе элементов
+     * @param ip IP-адрес устройства
+     * @param boardId Идентификатор платы
+     * @return Составной ключ
+     */
+    static QString boardKey(const QString &ip, const QString &boardId);
+
+    /**
+     * @brief Вывод строк в консоль
+     * @param rows Разобранные объекты
+     */
+    void printRowsToConsole(const QList<QJsonObject> &rows);
 
     // Сетевые компоненты
     QTcpSocket *socket;
+    QLocalSocket *localSocket;
+    JsonStreamParser *jsonParser;
     
     // UI компоненты
     QTreeWidget *treeWidget;
     QLabel *statusLabel;
     
+    // Элементы дерева по ключам; очищаются вместе с деревом
+    QHash<QString, QTreeWidgetItem*> deviceItems;
+    QHash<QString, QTreeWidgetItem*> boardItems;
+    
+    // Загруженные поддеревья; переживают перезагрузку списка устройств
+    QHash<QString, QJsonArray> boardCache;
+    QHash<QString, QJsonArray> portCache;
+    
+    // Запросы, ответ на которые ещё не получен
+    QSet<QString> pendingBoards;
+    QSet<QString> pendingPorts;
+    
     // Параметры подключения
     QString serverAddress;
     int serverPort;
+    QString localServerName;
     
     // Режим работы
     bool isConsoleMode;
     QTextStream consoleOut;
     bool dataReceived;
+    bool requestFailed;
+    // Причина последнего отказа сервера, показывается рядом со статусом
+    QString lastServerError;
     
     // Константы
     static const QString DEFAULT_SERVER_ADDRESS;
     static const int DEFAULT_SERVER_PORT = 12345;
     static const int RECONNECT_TIMEOUT_MS = 5000;
     static const int CONSOLE_TIMEOUT_MS = 30000; // 30 секунд таймаут для консольного режима
+    static const int MIN_RETRY_DELAY_MS = 200;
+    static const int PREFETCH_NEIGHBOURS = 8;
+    
+    // Роли данных элементов дерева
+    enum ItemRole {
+        ItemTypeRole = Qt::UserRole,
+        IpRole,
+        BoardIdRole,
+        LoadedRole
+    };
+    
+    // Типы элементов дерева
+    enum ItemType {
+        DeviceItem,
+        BoardItem,
+        PortItem,
+        PlaceholderItem
+    };
 };
 
 #endif // CLIENT_H 
\ No newline at end of file
@@ -3,11 +3,19 @@ CONFIG   += c++17
 TARGET    = client
 TEMPLATE  = app
 
+INCLUDEPATH += $$PWD/../common
+
 SOURCES += \
     $$PWD/main.cpp \
-    $$PWD/client.cpp
+    $$PWD/client.cpp \
+    $$PWD/jsonstreamparser.cpp \
+    $$PWD/../common/tracer.cpp \
+    $$PWD/../common/eventloopwatchdog.cpp
 
 HEADERS += \
-    $$PWD/client.h 
+    $$PWD/client.h \
+    $$PWD/jsonstreamparser.h \
+    $$PWD/../common/tracer.h \
+    $$PWD/../common/eventloopwatchdog.h 
 
 VERSION = 1.0.0 
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "jsonstreamparser.h"
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+const int JsonStreamParser::MAX_BATCH_SIZE;  // Уже инициализирован в заголовочном файле
+
+static inline bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+JsonStreamParser::JsonStreamParser(QObject *parent) : QObject(parent)
+{
+    reset();
+}
+
+void JsonStreamParser::reset()
+{
+    started = false;
+    finished = false;
+    failed = false;
+    inElement = false;
+    inString = false;
+    escaped = false;
+    topLevelObject = false;
+    depth = 0;
+    rowCount = 0;
+    elementBuffer.clear();
+    pendingRows.clear();
+}
+
+bool JsonStreamParser::isFinished() const
+{
+    return finished;
+}
+
+bool JsonStreamParser::hasError() const
+{
+    return failed;
+}
+
+void JsonStreamParser::feed(const QByteArray &chunk)
+{
+    if (failed) {
+        return;
+    }
+
+    const char *data = chunk.constData();
+    const int size = chunk.size();
+    // Начало незавершённого элемента внутри текущей порции (-1, если элемента нет)
+    int elementStart = inElement ? 0 : -1;
+
+    for (int i = 0; i < size && !failed; ++i) {
+        const char c = data[i];
+
+        // Внутри строки важны только экранирование и закрывающая кавычка.
+        // Байты многобайтовых символов UTF-8 всегда >= 0x80 и не совпадают с ними.
+        if (inString) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                inString = false;
+            }
+            continue;
+        }
+
+        // Ожидаем начало нового документа: массива строк или отдельного объекта
+        if (!started || finished) {
+            if (isJsonSpace(c)) {
+                continue;
+            }
+            if (c == '{') {
+                // Объект верхнего уровня собирается целиком и разбирается сразу
+                started = true;
+                finished = false;
+                topLevelObject = true;
+                depth = 0;
+                inElement = true;
+                elementStart = i;
+            } else if (c == '[') {
+                started = true;
+                finished = false;
+                topLevelObject = false;
+                depth = 1;
+                rowCount = 0;
+                emit arrayStarted();
+                continue;
+            } else {
+                fail("Полученные данные не являются массивом или объектом JSON");
+                break;
+            }
+        }
+
+        // Между элементами массива
+        if (!inElement) {
+            if (isJsonSpace(c) || c == ',') {
+                continue;
+            }
+            if (c == ']') {
+                finished = true;
+                depth = 0;
+                flushRows();
+                emit arrayFinished(rowCount);
+                continue;
+            }
+            inElement = true;
+            elementStart = i;
+        }
+
+        // Внутри элемента; он завершается возвратом на глубину baseDepth
+        const int baseDepth = topLevelObject ? 0 : 1;
+        if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (!topLevelObject && depth == 1 && (c == ',' || c == ']' || isJsonSpace(c))) {
+            // Конец скалярного элемента; сам разделитель обрабатываем повторно
+            elementBuffer.append(data + elementStart, i - elementStart);
+            elementStart = -1;
+            completeElement();
+            --i;
+        } else if (c == '}' || c == ']') {
+            --depth;
+            if (depth < baseDepth) {
+                fail("Непарная закрывающая скобка в данных JSON");
+                break;
+            }
+            if (depth == baseDepth) {
+                elementBuffer.append(data + elementStart, i + 1 - elementStart);
+                elementStart = -1;
+                completeElement();
+            }
+        }
+    }
+
+    // Сохраняем хвост незавершённого элемента до следующей порции
+    if (!failed && inElement && elementStart >= 0) {
+        elementBuffer.append(data + elementStart, size - elementStart);
+    }
+
+    flushRows();
+}
+
+void JsonStreamParser::completeElement()
+{
+    inElement = false;
+
+    if (topLevelObject) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(elementBuffer, &parseError);
+        elementBuffer.clear();
+        if (parseError.error != QJsonParseError::NoError) {
+            fail(parseError.errorString());
+            return;
+        }
+        topLevelObject = false;
+        finished = true;
+        depth = 0;
+        emit objectReady(doc.object());
+        return;
+    }
+
+    if (elementBuffer.startsWith('{')) {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(elementBuffer, &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            fail(parseError.errorString());
+            return;
+        }
+        pendingRows.append(doc.object());
+    } else {
+        // Элементы, не являющиеся объектами, отображаются пустыми строками
+        pendingRows.append(QJsonObject());
+    }
+
+    elementBuffer.clear();
+    ++rowCount;
+
+    if (pendingRows.size() >= MAX_BATCH_SIZE) {
+        flushRows();
+    }
+}
+
+void JsonStreamParser::flushRows()
+{
+    if (pendingRows.isEmpty()) {
+        return;
+    }
+
+    QList<QJsonObject> rows;
+    rows.swap(pendingRows);
+    emit rowsReady(rows);
+}
+
+void JsonStreamParser::fail(const QString &message)
+{
+    failed = true;
+    elementBuffer.clear();
+    pendingRows.clear();
+    emit parseError(message);
+}
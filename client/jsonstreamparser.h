@@ -0,0 +1,119 @@
+#ifndef JSONSTREAMPARSER_H
+#define JSONSTREAMPARSER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+
+/**
+ * @brief Инкрементальный разборщик JSON-массива объектов
+ *
+ * Принимает данные по частям по мере их поступления из сокета и сохраняет
+ * состояние незавершённого элемента между вызовами feed(). Готовые элементы
+ * массива выдаются пачками через сигнал rowsReady(), поэтому в памяти
+ * хранится только текущий неполный элемент, а не весь документ.
+ * Небольшие ответы-объекты верхнего уровня выдаются целиком через objectReady().
+ */
+class JsonStreamParser : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Конструктор класса JsonStreamParser
+     * @param parent Родительский объект
+     */
+    explicit JsonStreamParser(QObject *parent = nullptr);
+
+    /**
+     * @brief Передать очередную порцию данных
+     * @param chunk Полученные из сокета байты
+     */
+    void feed(const QByteArray &chunk);
+
+    /**
+     * @brief Сбросить состояние разборщика перед новым документом
+     */
+    void reset();
+
+    /**
+     * @brief Проверить, разобран ли текущий документ полностью
+     * @return true, если получена закрывающая скобка массива или объекта
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief Проверить, произошла ли ошибка разбора
+     * @return true, если данные не удалось разобрать
+     */
+    bool hasError() const;
+
+signals:
+    /**
+     * @brief Начат новый массив
+     */
+    void arrayStarted();
+
+    /**
+     * @brief Получена пачка готовых элементов
+     * @param rows Разобранные объекты в порядке поступления
+     */
+    void rowsReady(const QList<QJsonObject> &rows);
+
+    /**
+     * @brief Массив разобран полностью
+     * @param rowCount Общее количество элементов
+     */
+    void arrayFinished(int rowCount);
+
+    /**
+     * @brief Получен объект верхнего уровня
+     * @param object Разобранный объект
+     */
+    void objectReady(const QJsonObject &object);
+
+    /**
+     * @brief Ошибка разбора данных
+     * @param message Описание ошибки
+     */
+    void parseError(const QString &message);
+
+private:
+    /**
+     * @brief Завершить текущий элемент и добавить его в пачку
+     */
+    void completeElement();
+
+    /**
+     * @brief Отправить накопленную пачку элементов
+     */
+    void flushRows();
+
+    /**
+     * @brief Перевести разборщик в состояние ошибки
+     * @param message Описание ошибки
+     */
+    void fail(const QString &message);
+
+    // Состояние разбора
+    bool started;
+    bool finished;
+    bool failed;
+    bool inElement;
+    bool inString;
+    bool escaped;
+    bool topLevelObject;
+    int depth;
+    int rowCount;
+
+    // Байты незавершённого элемента
+    QByteArray elementBuffer;
+
+    // Готовые элементы, ещё не отправленные через rowsReady()
+    QList<QJsonObject> pendingRows;
+
+    // Константы
+    static const int MAX_BATCH_SIZE = 500;
+};
+
+#endif // JSONSTREAMPARSER_H
@@ -1,7 +1,11 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <QMessageBox>
+#include <QTextStream>
 #include "client.h"
+#include "tracer.h"
+#include "eventloopwatchdog.h"
 
 int main(int argc, char *argv[])
 {
@@ -30,12 +34,45 @@ int main(int argc, char *argv[])
                                  "Порт сервера", "port", "12345");
     parser.addOption(portOption);
     
+    QCommandLineOption localOption(QStringList() << "l" << "local", 
+                                  "Имя локального сокета сервера (вместо TCP)", "name");
+    parser.addOption(localOption);
+    
+    QCommandLineOption traceOption(QStringList() << "t" << "trace", 
+                                  "Записывать трассировку в файл формата Chrome trace-event", "file");
+    parser.addOption(traceOption);
+    
+    QCommandLineOption stallOption(QStringList() << "s" << "stall-threshold", 
+                                  "Порог задержки цикла событий для предупреждения, мс (0 - отключить)", 
+                                  "ms", "200");
+    parser.addOption(stallOption);
+    
     // Обработка параметров командной строки
     parser.process(a);
     
     // Определение режима работы
     bool consoleMode = parser.isSet(consoleOption);
     
+    // Диагностика цикла событий
+    bool stallOk = false;
+    int stallThresholdMs = parser.value(stallOption).toInt(&stallOk);
+    if (!stallOk || stallThresholdMs < 0) {
+        const QString message = "Неверный порог задержки. Должно быть неотрицательное число миллисекунд.";
+        if (consoleMode) {
+            QTextStream(stdout) << "Ошибка: " << message << Qt::endl;
+        } else {
+            QMessageBox::warning(nullptr, "Ошибка", message);
+        }
+        return 1;
+    }
+    
+    if (parser.isSet(traceOption)) {
+        Tracer::instance().enableExport(parser.value(traceOption));
+    }
+    
+    EventLoopWatchdog watchdog;
+    watchdog.start(stallThresholdMs);
+    
     // Создание клиента
     Client client(consoleMode);
     
@@ -46,7 +83,10 @@ int main(int argc, char *argv[])
     
     // Запуск в соответствующем режиме
     if (consoleMode) {
-        return client.runConsoleMode();
+        int result = client.runConsoleMode();
+        // Консольный режим не запускает a.exec(), поэтому aboutToQuit не придёт
+        Tracer::instance().finish();
+        return result;
     } else {
         client.connectToServer();
         client.show();
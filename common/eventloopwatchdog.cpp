@@ -0,0 +1,88 @@
+#include "eventloopwatchdog.h"
+#include "tracer.h"
+#include <QDebug>
+
+// Инициализация статических констант
+const int EventLoopWatchdog::DEFAULT_THRESHOLD_MS;  // Уже инициализирован в заголовочном файле
+const int EventLoopWatchdog::TICK_INTERVAL_MS;  // Уже инициализирован в заголовочном файле
+
+EventLoopWatchdog::EventLoopWatchdog(QObject *parent) : QObject(parent),
+    monitorThread(nullptr), thresholdMs(DEFAULT_THRESHOLD_MS),
+    lastTickUs(0), stalledHandler(nullptr), stallDetected(false), stopRequested(false)
+{
+    connect(&tickTimer, &QTimer::timeout, this, &EventLoopWatchdog::handleTick);
+}
+
+EventLoopWatchdog::~EventLoopWatchdog()
+{
+    stop();
+}
+
+void EventLoopWatchdog::start(int threshold)
+{
+    if (threshold <= 0 || monitorThread) {
+        return;
+    }
+
+    thresholdMs = threshold;
+    lastTickUs = Tracer::instance().nowUs();
+    stallDetected = false;
+    stopRequested = false;
+
+    // Точный таймер: иначе Qt может сдвигать срабатывания на 5%
+    tickTimer.setTimerType(Qt::PreciseTimer);
+    tickTimer.start(TICK_INTERVAL_MS);
+
+    monitorThread = QThread::create([this]() { monitorLoop(); });
+    monitorThread->start(QThread::LowPriority);
+}
+
+void EventLoopWatchdog::stop()
+{
+    tickTimer.stop();
+
+    if (monitorThread) {
+        stopRequested = true;
+        monitorThread->wait();
+        delete monitorThread;
+        monitorThread = nullptr;
+    }
+}
+
+void EventLoopWatchdog::handleTick()
+{
+    Tracer &tracer = Tracer::instance();
+    const qint64 now = tracer.nowUs();
+    const qint64 lagMs = (now - lastTickUs.exchange(now)) / 1000 - TICK_INTERVAL_MS;
+    const bool detected = stallDetected.exchange(false);
+
+    if (lagMs < thresholdMs) {
+        return;
+    }
+
+    // Обработчик уже завершился; его имя сохранил поток наблюдения
+    const char *handler = detected ? stalledHandler.load() : nullptr;
+
+    qWarning() << "Цикл событий был заблокирован на" << lagMs << "мс, обработчик:"
+               << (handler ? handler : "неизвестен");
+    tracer.addStall(lagMs, handler);
+}
+
+void EventLoopWatchdog::monitorLoop()
+{
+    Tracer &tracer = Tracer::instance();
+    const int pollMs = qMax(1, thresholdMs / 4);
+
+    while (!stopRequested) {
+        QThread::msleep(pollMs);
+
+        const qint64 silenceMs = (tracer.nowUs() - lastTickUs.load()) / 1000 - TICK_INTERVAL_MS;
+        if (silenceMs < thresholdMs || stallDetected) {
+            continue;
+        }
+
+        // Запоминаем первый обработчик, замеченный во время задержки
+        stalledHandler = tracer.currentSpan();
+        stallDetected = true;
+    }
+}
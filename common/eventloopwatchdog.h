@@ -0,0 +1,69 @@
+#ifndef EVENTLOOPWATCHDOG_H
+#define EVENTLOOPWATCHDOG_H
+
+#include <QObject>
+#include <QTimer>
+#include <QThread>
+#include <atomic>
+
+/**
+ * @brief Сторож цикла событий главного потока
+ *
+ * Таймер главного потока регулярно отмечается и измеряет собственное
+ * опоздание. Отдельный поток проверяет отметки: если главный поток не
+ * отвечает дольше порога, он запоминает выполняющийся в этот момент
+ * обработчик (самый вложенный TraceSpan). Когда цикл событий оживает,
+ * задержка и обработчик пишутся в журнал и в трассировку.
+ */
+class EventLoopWatchdog : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Конструктор класса EventLoopWatchdog
+     * @param parent Родительский объект
+     */
+    explicit EventLoopWatchdog(QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор класса EventLoopWatchdog
+     */
+    virtual ~EventLoopWatchdog();
+
+    /**
+     * @brief Запустить наблюдение
+     * @param threshold Задержка цикла событий, о которой нужно сообщать, мс (0 - отключить)
+     */
+    void start(int threshold = DEFAULT_THRESHOLD_MS);
+
+    /**
+     * @brief Остановить наблюдение
+     */
+    void stop();
+
+private slots:
+    void handleTick();
+
+private:
+    /**
+     * @brief Цикл проверки отметок в отдельном потоке
+     */
+    void monitorLoop();
+
+    QTimer tickTimer;
+    QThread *monitorThread;
+    int thresholdMs;
+
+    // Время последней отметки главного потока, мкс
+    std::atomic<qint64> lastTickUs;
+    // Обработчик, замеченный во время текущей задержки
+    std::atomic<const char *> stalledHandler;
+    std::atomic<bool> stallDetected;
+    std::atomic<bool> stopRequested;
+
+    // Константы
+    static const int DEFAULT_THRESHOLD_MS = 200;
+    static const int TICK_INTERVAL_MS = 50;
+};
+
+#endif // EVENTLOOPWATCHDOG_H
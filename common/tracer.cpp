@@ -0,0 +1,183 @@
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QDebug>
+
+const int Tracer::MAX_EVENTS;  // Уже инициализирован в заголовочном файле
+
+Tracer &Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer(QObject *parent) : QObject(parent),
+    activeSpan(nullptr), enabled(false), appendedEvents(0), exportedEvents(0),
+    exportHasEvents(false)
+{
+    clock.start();
+    connect(&exportTimer, &QTimer::timeout, this, &Tracer::exportNewEvents);
+}
+
+void Tracer::enableExport(const QString &filePath, int intervalMs)
+{
+    exportFile.setFileName(filePath);
+    if (!exportFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Не удалось открыть файл трассировки:" << filePath;
+        return;
+    }
+    exportFile.write("[\n");
+    pidString = QByteArray::number(QCoreApplication::applicationPid());
+
+    enabled = true;
+    events.reserve(MAX_EVENTS);
+
+    // Сервер обычно останавливают сигналом, поэтому сохраняем и периодически
+    if (intervalMs > 0) {
+        exportTimer.start(intervalMs);
+    }
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+            this, &Tracer::finish, Qt::UniqueConnection);
+}
+
+void Tracer::finish()
+{
+    exportTimer.stop();
+    if (!exportFile.isOpen()) {
+        return;
+    }
+    exportNewEvents();
+    enabled = false;
+    exportFile.write("\n]\n");
+    exportFile.close();
+}
+
+bool Tracer::isEnabled() const
+{
+    return enabled;
+}
+
+qint64 Tracer::nowUs() const
+{
+    return clock.nsecsElapsed() / 1000;
+}
+
+void Tracer::addSpan(const char *name, qint64 startUs, qint64 durationUs)
+{
+    if (!enabled) {
+        return;
+    }
+    append({name, startUs, durationUs, 0, false});
+}
+
+void Tracer::addStall(qint64 lagMs, const char *handler)
+{
+    if (!enabled) {
+        return;
+    }
+    append({handler, nowUs() - lagMs * 1000, lagMs * 1000, lagMs, true});
+}
+
+const char *Tracer::currentSpan() const
+{
+    return activeSpan.load(std::memory_order_relaxed);
+}
+
+const char *Tracer::enterSpan(const char *name)
+{
+    return activeSpan.exchange(name, std::memory_order_relaxed);
+}
+
+void Tracer::leaveSpan(const char *previous)
+{
+    activeSpan.store(previous, std::memory_order_relaxed);
+}
+
+void Tracer::append(const TraceEvent &event)
+{
+    if (events.size() < MAX_EVENTS) {
+        events.append(event);
+    } else {
+        // Буфер заполнен - перезаписываем самые старые события
+        events[int(appendedEvents % MAX_EVENTS)] = event;
+    }
+    ++appendedEvents;
+}
+
+static void appendJsonString(QByteArray &out, const char *text)
+{
+    // Имена участков - строковые литералы из кода, экранируем на всякий случай
+    out += '"';
+    for (const char *p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            out += '\\';
+        }
+        out += *p;
+    }
+    out += '"';
+}
+
+bool Tracer::exportNewEvents()
+{
+    TRACE_SPAN("Tracer::exportNewEvents");
+
+    if (!exportFile.isOpen()) {
+        return false;
+    }
+
+    // События, вытесненные из буфера до сохранения, теряются
+    quint64 first = exportedEvents;
+    if (appendedEvents - first > quint64(MAX_EVENTS)) {
+        first = appendedEvents - MAX_EVENTS;
+        qWarning() << "Трассировка: потеряно событий:" << first - exportedEvents;
+    }
+
+    // Формируем JSON вручную: QJsonObject на событие делал сохранение
+    // заметной задержкой цикла событий
+    QByteArray out;
+    out.reserve(int(appendedEvents - first) * 112);
+    for (quint64 n = first; n < appendedEvents; ++n) {
+        const TraceEvent &event = events.at(int(n % MAX_EVENTS));
+
+        out += exportHasEvents ? ",\n{\"ph\":\"X\",\"pid\":" : "{\"ph\":\"X\",\"pid\":";
+        exportHasEvents = true;
+        out += pidString;
+        out += ",\"tid\":1,\"ts\":";
+        out += QByteArray::number(event.startUs);
+        out += ",\"dur\":";
+        out += QByteArray::number(event.durationUs);
+        if (event.stall) {
+            out += ",\"name\":\"event loop stall\",\"cat\":\"stall\",\"args\":{\"lag_ms\":";
+            out += QByteArray::number(event.lagMs);
+            out += ",\"handler\":";
+            appendJsonString(out, event.name ? event.name : "unknown");
+            out += "}}";
+        } else {
+            out += ",\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"cat\":\"span\"}";
+        }
+    }
+    exportedEvents = appendedEvents;
+
+    if (exportFile.write(out) != out.size() || !exportFile.flush()) {
+        qWarning() << "Не удалось сохранить файл трассировки:" << exportFile.fileName();
+        return false;
+    }
+    return true;
+}
+
+TraceSpan::TraceSpan(const char *name) : name(name)
+{
+    Tracer &tracer = Tracer::instance();
+    previous = tracer.enterSpan(name);
+    startUs = tracer.isEnabled() ? tracer.nowUs() : -1;
+}
+
+TraceSpan::~TraceSpan()
+{
+    Tracer &tracer = Tracer::instance();
+    tracer.leaveSpan(previous);
+    if (startUs >= 0) {
+        tracer.addSpan(name, startUs, tracer.nowUs() - startUs);
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QTimer>
+#include <QFile>
+#include <atomic>
+
+/**
+ * @brief Сборщик трассировки в формате Chrome trace-event
+ *
+ * Накапливает события в кольцевом буфере и периодически дописывает новые
+ * в файл формата JSON Array, который открывается в chrome://tracing или
+ * Perfetto даже без закрывающей скобки, то есть и после аварийного завершения.
+ * Пока трассировка не включена, TraceSpan только отмечает текущий
+ * обработчик для EventLoopWatchdog и ничего не записывает.
+ * Все методы, кроме currentSpan() и nowUs(), вызываются из главного потока.
+ */
+class Tracer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Единственный экземпляр трассировщика
+     */
+    static Tracer &instance();
+
+    /**
+     * @brief Включить запись событий и их сохранение в файл
+     * @param filePath Путь к файлу трассировки
+     * @param intervalMs Период сохранения, мс (0 - только при завершении)
+     */
+    void enableExport(const QString &filePath, int intervalMs = 10000);
+
+    /**
+     * @brief Остановить периодическое сохранение, дописать оставшиеся события и закрыть файл
+     *
+     * Вызывается автоматически при aboutToQuit; программам, завершающимся
+     * без цикла событий, нужно вызвать его явно.
+     */
+    void finish();
+
+    /**
+     * @brief Проверить, включена ли запись событий
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Время с момента запуска трассировщика, мкс (потокобезопасно)
+     */
+    qint64 nowUs() const;
+
+    /**
+     * @brief Добавить завершённый участок
+     * @param name Имя участка (строковый литерал)
+     * @param startUs Начало, мкс
+     * @param durationUs Длительность, мкс
+     */
+    void addSpan(const char *name, qint64 startUs, qint64 durationUs);
+
+    /**
+     * @brief Добавить событие задержки цикла событий
+     * @param lagMs Величина задержки, мс
+     * @param handler Обработчик, выполнявшийся во время задержки
+     */
+    void addStall(qint64 lagMs, const char *handler);
+
+    /**
+     * @brief Обработчик, выполняющийся сейчас в главном потоке (потокобезопасно)
+     * @return Имя самого вложенного активного участка или nullptr
+     */
+    const char *currentSpan() const;
+
+    /**
+     * @brief Сделать участок текущим
+     * @param name Имя участка
+     * @return Предыдущий текущий участок
+     */
+    const char *enterSpan(const char *name);
+
+    /**
+     * @brief Восстановить предыдущий текущий участок
+     * @param previous Значение, возвращённое enterSpan()
+     */
+    void leaveSpan(const char *previous);
+
+private:
+    explicit Tracer(QObject *parent = nullptr);
+
+    /**
+     * @brief Дописать в файл события, добавленные после прошлого сохранения
+     * @return true при успешной записи
+     */
+    bool exportNewEvents();
+
+    struct TraceEvent {
+        const char *name;
+        qint64 startUs;
+        qint64 durationUs;
+        qint64 lagMs;      // только для задержек
+        bool stall;
+    };
+
+    void append(const TraceEvent &event);
+
+    QElapsedTimer clock;
+    std::atomic<const char *> activeSpan;
+    bool enabled;
+
+    // Кольцевой буфер последних событий; событие с номером n лежит
+    // в ячейке n % MAX_EVENTS
+    QVector<TraceEvent> events;
+    quint64 appendedEvents;
+    quint64 exportedEvents;
+
+    QFile exportFile;
+    QByteArray pidString;
+    bool exportHasEvents;
+    QTimer exportTimer;
+
+    static const int MAX_EVENTS = 200000;
+};
+
+/**
+ * @brief Участок трассировки, охватывающий область видимости
+ */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name;
+    const char *previous;
+    qint64 startUs;
+};
+
+#define TRACE_SPAN_CONCAT_IMPL(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT_IMPL(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_SPAN_CONCAT(traceSpan, __LINE__)(name)
+
+#endif // TRACER_H
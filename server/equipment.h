@@ -0,0 +1,62 @@
+#ifndef EQUIPMENT_H
+#define EQUIPMENT_H
+
+#include <QString>
+#include <QList>
+
+struct Port {
+    QString id;
+    int num = 0;
+    int media = 0;
+    int signal = 0;
+};
+
+struct Board {
+    QString id;
+    int num = 0;
+    QString name;
+    int portCount = 0;
+    QString intLinks;
+    QString algorithms;
+    QList<Port> ports;
+};
+
+struct Equipment {
+    QString blockId;
+    QString name;
+    QString ip;
+    int boardCount = 0;
+    int mtR = 0;
+    int mtC = 0;
+    QString description;
+    QString label;
+    QList<Board> boards;
+};
+
+// Сравнение используется для сверки результатов разных парсеров XML
+inline bool operator==(const Port &a, const Port &b)
+{
+    return a.id == b.id && a.num == b.num && a.media == b.media && a.signal == b.signal;
+}
+
+inline bool operator==(const Board &a, const Board &b)
+{
+    return a.id == b.id && a.num == b.num && a.name == b.name &&
+           a.portCount == b.portCount && a.intLinks == b.intLinks &&
+           a.algorithms == b.algorithms && a.ports == b.ports;
+}
+
+inline bool operator==(const Equipment &a, const Equipment &b)
+{
+    return a.blockId == b.blockId && a.name == b.name && a.ip == b.ip &&
+           a.boardCount == b.boardCount && a.mtR == b.mtR && a.mtC == b.mtC &&
+           a.description == b.description && a.label == b.label &&
+           a.boards == b.boards;
+}
+
+inline bool operator!=(const Equipment &a, const Equipment &b)
+{
+    return !(a == b);
+}
+
+#endif // EQUIPMENT_H
@@ -0,0 +1,454 @@
+#include "fastxmlparser.h"
+#include <QByteArray>
+#include <cstring>
+#include <climits>
+#include <utility>
+
+namespace {
+
+enum ElementKind {
+    DeviceElement,
+    BlockElement,
+    BoardElement,
+    PortElement,
+    UnknownElement
+};
+
+struct Cursor {
+    const char *pos;
+    const char *end;
+
+    bool atEnd() const { return pos >= end; }
+
+    bool startsWith(const char *literal) const
+    {
+        const size_t length = strlen(literal);
+        return size_t(end - pos) >= length && memcmp(pos, literal, length) == 0;
+    }
+};
+
+struct Attribute {
+    const char *name;
+    int nameLength;
+    const char *value;
+    int valueLength;
+};
+
+inline bool isXmlSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isNameChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == ':' || c == '-' || c == '.';
+}
+
+bool skipSpaces(Cursor &c)
+{
+    const char *start = c.pos;
+    while (!c.atEnd() && isXmlSpace(*c.pos)) {
+        ++c.pos;
+    }
+    return c.pos != start;
+}
+
+bool nameIs(const char *name, int length, const char *literal)
+{
+    return int(strlen(literal)) == length && memcmp(name, literal, length) == 0;
+}
+
+bool readName(Cursor &c, const char *&name, int &length)
+{
+    name = c.pos;
+    while (!c.atEnd() && isNameChar(*c.pos)) {
+        ++c.pos;
+    }
+    length = int(c.pos - name);
+    return length > 0;
+}
+
+ElementKind elementKind(const char *name, int length)
+{
+    if (nameIs(name, length, "device")) return DeviceElement;
+    if (nameIs(name, length, "block")) return BlockElement;
+    if (nameIs(name, length, "board")) return BoardElement;
+    if (nameIs(name, length, "port")) return PortElement;
+    return UnknownElement;
+}
+
+// Разбор целого числа прямо из байтов атрибута. Пустое значение даёт 0,
+// как QStringView::toInt(); всё остальное, кроме десятичных цифр, отклоняется.
+bool parseInt(const char *p, int length, int &result)
+{
+    if (length == 0) {
+        result = 0;
+        return true;
+    }
+
+    bool negative = false;
+    if (*p == '-') {
+        negative = true;
+        ++p;
+        --length;
+        if (length == 0) {
+            return false;
+        }
+    }
+
+    qint64 value = 0;
+    for (int i = 0; i < length; ++i) {
+        const char c = p[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+        if (value > qint64(INT_MAX) + 1) {
+            return false;
+        }
+    }
+
+    if (negative) {
+        value = -value;
+    }
+    if (value > INT_MAX || value < INT_MIN) {
+        return false;
+    }
+
+    result = int(value);
+    return true;
+}
+
+inline QString toString(const Attribute &attr)
+{
+    return QString::fromUtf8(attr.value, attr.valueLength);
+}
+
+// Чтение атрибута name="value". Значения со ссылками на сущности или
+// пробельными символами, требующими нормализации, отдаются QXmlStreamReader.
+bool readAttribute(Cursor &c, Attribute &attr)
+{
+    if (!readName(c, attr.name, attr.nameLength)) {
+        return false;
+    }
+
+    skipSpaces(c);
+    if (c.atEnd() || *c.pos != '=') {
+        return false;
+    }
+    ++c.pos;
+    skipSpaces(c);
+
+    if (c.atEnd() || (*c.pos != '"' && *c.pos != '\'')) {
+        return false;
+    }
+    const char quote = *c.pos++;
+
+    attr.value = c.pos;
+    while (!c.atEnd() && *c.pos != quote) {
+        const char ch = *c.pos;
+        if (ch == '&' || ch == '<' || ch == '\t' || ch == '\n' || ch == '\r') {
+            return false;
+        }
+        ++c.pos;
+    }
+    if (c.atEnd()) {
+        return false;
+    }
+    attr.valueLength = int(c.pos - attr.value);
+    ++c.pos;
+    return true;
+}
+
+// Поиск атрибута в списке известных имён. Повторный атрибут - ошибка XML,
+// поэтому такой файл тоже уходит на общий парсер.
+int attributeIndex(const Attribute &attr, const char *const *names, int count, unsigned &seen)
+{
+    for (int i = 0; i < count; ++i) {
+        if (nameIs(attr.name, attr.nameLength, names[i])) {
+            if (seen & (1u << i)) {
+                return -1;
+            }
+            seen |= 1u << i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool applyBlockAttribute(const Attribute &attr, Equipment &equipment, unsigned &seen)
+{
+    static const char *const names[] = {
+        "id", "Name", "IP", "BoardCount", "MtR", "MtC", "Description", "Label"
+    };
+
+    switch (attributeIndex(attr, names, 8, seen)) {
+    case 0: equipment.blockId = toString(attr); return true;
+    case 1: equipment.name = toString(attr); return true;
+    case 2: equipment.ip = toString(attr); return true;
+    case 3: return parseInt(attr.value, attr.valueLength, equipment.boardCount);
+    case 4: return parseInt(attr.value, attr.valueLength, equipment.mtR);
+    case 5: return parseInt(attr.value, attr.valueLength, equipment.mtC);
+    case 6: equipment.description = toString(attr); return true;
+    case 7: equipment.label = toString(attr); return true;
+    default: return false;
+    }
+}
+
+bool applyBoardAttribute(const Attribute &attr, Board &board, unsigned &seen)
+{
+    static const char *const names[] = {
+        "id", "Num", "Name", "PortCount", "IntLinks", "Algoritms"
+    };
+
+    switch (attributeIndex(attr, names, 6, seen)) {
+    case 0: board.id = toString(attr); return true;
+    case 1: return parseInt(attr.value, attr.valueLength, board.num);
+    case 2: board.name = toString(attr); return true;
+    case 3: return parseInt(attr.value, attr.valueLength, board.portCount);
+    case 4: board.intLinks = toString(attr); return true;
+    case 5: board.algorithms = toString(attr); return true;
+    default: return false;
+    }
+}
+
+bool applyPortAttribute(const Attribute &attr, Port &port, unsigned &seen)
+{
+    static const char *const names[] = { "id", "Num", "Media", "Signal" };
+
+    switch (attributeIndex(attr, names, 4, seen)) {
+    case 0: port.id = toString(attr); return true;
+    case 1: return parseInt(attr.value, attr.valueLength, port.num);
+    case 2: return parseInt(attr.value, attr.valueLength, port.media);
+    case 3: return parseInt(attr.value, attr.valueLength, port.signal);
+    default: return false;
+    }
+}
+
+// Пропуск комментария <!-- ... -->; "--" внутри комментария недопустимо
+bool skipComment(Cursor &c)
+{
+    c.pos += 4;
+    while (c.end - c.pos >= 2) {
+        if (c.pos[0] == '-' && c.pos[1] == '-') {
+            if (c.end - c.pos >= 3 && c.pos[2] == '>') {
+                c.pos += 3;
+                return true;
+            }
+            return false;
+        }
+        ++c.pos;
+    }
+    return false;
+}
+
+// Разбор объявления <?xml ... ?>; поддерживается только UTF-8
+bool skipDeclaration(Cursor &c)
+{
+    const char *start = c.pos;
+    const char *close = nullptr;
+    for (const char *p = start; p + 1 < c.end; ++p) {
+        if (p[0] == '?' && p[1] == '>') {
+            close = p;
+            break;
+        }
+    }
+    if (!close) {
+        return false;
+    }
+
+    const char *key = "encoding";
+    const int keyLength = int(strlen(key));
+    for (const char *p = start; p + keyLength < close; ++p) {
+        if (memcmp(p, key, keyLength) != 0) {
+            continue;
+        }
+        Cursor attrCursor{p, close};
+        Attribute attr;
+        if (!readAttribute(attrCursor, attr) ||
+            attr.valueLength != 5 || qstrnicmp(attr.value, "UTF-8", 5) != 0) {
+            return false;
+        }
+        break;
+    }
+
+    c.pos = close + 2;
+    return true;
+}
+
+// Пропуск пробелов и комментариев вне элементов
+bool skipMisc(Cursor &c)
+{
+    for (;;) {
+        skipSpaces(c);
+        if (c.startsWith("<!--")) {
+            if (!skipComment(c)) {
+                return false;
+            }
+            continue;
+        }
+        return true;
+    }
+}
+
+} // namespace
+
+bool FastXmlParser::parse(const char *data, qint64 size, Equipment &equipment)
+{
+    if (!data || size <= 0 || size > INT_MAX) {
+        return false;
+    }
+
+    Cursor c{data, data + size};
+
+    // BOM UTF-8
+    if (c.startsWith("\xEF\xBB\xBF")) {
+        c.pos += 3;
+    }
+
+    // Объявление допускается только в самом начале документа
+    if (c.startsWith("<?xml") && c.end - c.pos > 5 && isXmlSpace(c.pos[5])) {
+        if (!skipDeclaration(c)) {
+            return false;
+        }
+    }
+
+    if (!skipMisc(c)) {
+        return false;
+    }
+
+    // Глубина вложенности ограничена схемой: device > block > board > port
+    ElementKind stack[4];
+    int depth = 0;
+    bool rootClosed = false;
+    Board *currentBoard = nullptr;
+
+    while (!rootClosed) {
+        if (c.atEnd() || *c.pos != '<') {
+            return false;
+        }
+
+        if (c.startsWith("<!--")) {
+            if (!skipComment(c)) {
+                return false;
+            }
+        } else if (c.startsWith("</")) {
+            c.pos += 2;
+            const char *name;
+            int nameLength;
+            if (!readName(c, name, nameLength) || depth == 0 ||
+                elementKind(name, nameLength) != stack[depth - 1]) {
+                return false;
+            }
+            skipSpaces(c);
+            if (c.atEnd() || *c.pos != '>') {
+                return false;
+            }
+            ++c.pos;
+
+            if (stack[--depth] == BoardElement) {
+                currentBoard = nullptr;
+            }
+            rootClosed = depth == 0;
+        } else {
+            ++c.pos;
+            const char *name;
+            int nameLength;
+            if (!readName(c, name, nameLength)) {
+                return false;
+            }
+
+            // Каждый элемент допустим только на своём уровне схемы
+            const ElementKind kind = elementKind(name, nameLength);
+            if (kind == UnknownElement || int(kind) != depth) {
+                return false;
+            }
+
+            Port *currentPort = nullptr;
+            if (kind == BlockElement) {
+                // Как и в QXmlStreamReader-парсере, каждый block заново задаёт поля
+                QList<Board> boards = std::move(equipment.boards);
+                equipment = Equipment();
+                equipment.boards = std::move(boards);
+            } else if (kind == BoardElement) {
+                equipment.boards.append(Board());
+                currentBoard = &equipment.boards.last();
+            } else if (kind == PortElement) {
+                currentBoard->ports.append(Port());
+                currentPort = &currentBoard->ports.last();
+            }
+
+            unsigned seen = 0;
+            bool selfClosing = false;
+            for (;;) {
+                const bool hadSpace = skipSpaces(c);
+                if (c.atEnd()) {
+                    return false;
+                }
+                if (*c.pos == '>') {
+                    ++c.pos;
+                    break;
+                }
+                if (*c.pos == '/') {
+                    ++c.pos;
+                    if (c.atEnd() || *c.pos != '>') {
+                        return false;
+                    }
+                    ++c.pos;
+                    selfClosing = true;
+                    break;
+                }
+                if (!hadSpace) {
+                    return false;
+                }
+
+                Attribute attr;
+                if (!readAttribute(c, attr)) {
+                    return false;
+                }
+
+                bool applied = false;
+                switch (kind) {
+                case BlockElement:
+                    applied = applyBlockAttribute(attr, equipment, seen);
+                    break;
+                case BoardElement:
+                    applied = applyBoardAttribute(attr, *currentBoard, seen);
+                    break;
+                case PortElement:
+                    applied = applyPortAttribute(attr, *currentPort, seen);
+                    break;
+                default:
+                    break;
+                }
+                if (!applied) {
+                    return false;
+                }
+            }
+
+            if (selfClosing) {
+                if (kind == BoardElement) {
+                    currentBoard = nullptr;
+                }
+                rootClosed = depth == 0;
+            } else {
+                stack[depth++] = kind;
+            }
+        }
+
+        if (rootClosed) {
+            break;
+        }
+
+        // Между тегами допускаются только пробельные символы
+        skipSpaces(c);
+    }
+
+    // После корневого элемента - только пробелы и комментарии
+    if (!skipMisc(c) || !c.atEnd()) {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef FASTXMLPARSER_H
+#define FASTXMLPARSER_H
+
+#include <QtGlobal>
+#include "equipment.h"
+
+// Быстрый разбор XML-описаний оборудования известной схемы
+// device/block/board/port прямо из отображённого в память файла.
+// Атрибуты читаются на месте, целые числа разбираются без промежуточных строк.
+// На любой неожиданной конструкции (сущности, CDATA, незнакомые элементы
+// или атрибуты, другая кодировка) parse() возвращает false, и вызывающий
+// код должен повторить разбор через QXmlStreamReader.
+class FastXmlParser
+{
+public:
+    static bool parse(const char *data, qint64 size, Equipment &equipment);
+};
+
+#endif // FASTXMLPARSER_H
@@ -1,14 +1,146 @@
 #include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QDebug>
 #include "server.h"
+#include "tracer.h"
+#include "eventloopwatchdog.h"
 
 int main(int argc, char *argv[])
 {
     QCoreApplication a(argc, argv);
     
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Сервер данных об оборудовании");
+    parser.addHelpOption();
+    
+    QCommandLineOption verifyXmlOption("verify-xml",
+                                      "Сверить быстрый парсер XML с QXmlStreamReader на файлах каталога и выйти",
+                                      "directory");
+    parser.addOption(verifyXmlOption);
+    
+    QCommandLineOption generateXmlOption("generate-xml",
+                                        "Создать в каталоге синтетический набор XML файлов и выйти",
+                                        "directory");
+    parser.addOption(generateXmlOption);
+    
+    QCommandLineOption countOption("count",
+                                  "Число файлов для --generate-xml",
+                                  "count", "10000");
+    parser.addOption(countOption);
+    
+    // Ограничения на подключения (0 отключает ограничение)
+    ServerLimits limits;
+    
+    QCommandLineOption maxConnectionsOption("max-connections",
+                                           "Максимальное число одновременных подключений",
+                                           "count", QString::number(limits.maxConnections));
+    parser.addOption(maxConnectionsOption);
+    
+    QCommandLineOption maxPeerConnectionsOption("max-connections-per-peer",
+                                               "Максимальное число одновременных подключений с одного адреса",
+                                               "count", QString::number(limits.maxConnectionsPerPeer));
+    parser.addOption(maxPeerConnectionsOption);
+    
+    QCommandLineOption maxOutputOption("max-output-bytes",
+                                      "Максимальный объём неотправленных данных на клиента",
+                                      "bytes", QString::number(limits.maxPendingOutputBytes));
+    parser.addOption(maxOutputOption);
+    
+    QCommandLineOption rateOption("rate",
+                                 "Допустимое число запросов в секунду с одного адреса",
+                                 "requests", QString::number(limits.requestsPerSecond));
+    parser.addOption(rateOption);
+    
+    QCommandLineOption burstOption("burst",
+                                  "Допустимая пачка запросов с одного адреса",
+                                  "requests", QString::number(limits.requestBurst));
+    parser.addOption(burstOption);
+    
+    QCommandLineOption idleTimeoutOption("idle-timeout",
+                                        "Таймаут бездействия клиента, мс",
+                                        "ms", QString::number(limits.idleTimeoutMs));
+    parser.addOption(idleTimeoutOption);
+    
+    QCommandLineOption handshakeTimeoutOption("handshake-timeout",
+                                             "Время ожидания первого запроса клиента, мс",
+                                             "ms", QString::number(limits.handshakeTimeoutMs));
+    parser.addOption(handshakeTimeoutOption);
+    
+    QCommandLineOption localOption("local",
+                                  "Имя локального сокета для клиентов на этом же узле (пустое - отключить)",
+                                  "name", "equipment-server");
+    parser.addOption(localOption);
+    
+    QCommandLineOption traceOption("trace",
+                                  "Записывать трассировку в файл формата Chrome trace-event",
+                                  "file");
+    parser.addOption(traceOption);
+    
+    QCommandLineOption stallOption("stall-threshold",
+                                  "Порог задержки цикла событий для предупреждения, мс (0 - отключить)",
+                                  "ms", "200");
+    parser.addOption(stallOption);
+    
+    parser.process(a);
+    
+    if (parser.isSet(generateXmlOption)) {
+        bool countOk = false;
+        int count = parser.value(countOption).toInt(&countOk);
+        if (!countOk || count <= 0) {
+            qCritical() << "Неверное число файлов:" << parser.value(countOption);
+            return 1;
+        }
+        return Server::generateXmlCorpus(parser.value(generateXmlOption), count) ? 0 : 1;
+    }
+    
+    if (parser.isSet(verifyXmlOption)) {
+        return Server::verifyXmlParsers(parser.value(verifyXmlOption)) ? 0 : 1;
+    }
+    
+    bool ok = true;
+    bool valid = true;
+    limits.maxConnections = parser.value(maxConnectionsOption).toInt(&ok);
+    valid = valid && ok && limits.maxConnections >= 0;
+    limits.maxConnectionsPerPeer = parser.value(maxPeerConnectionsOption).toInt(&ok);
+    valid = valid && ok && limits.maxConnectionsPerPeer >= 0;
+    limits.maxPendingOutputBytes = parser.value(maxOutputOption).toLongLong(&ok);
+    valid = valid && ok && limits.maxPendingOutputBytes >= 0;
+    limits.requestsPerSecond = parser.value(rateOption).toDouble(&ok);
+    valid = valid && ok && limits.requestsPerSecond >= 0;
+    limits.requestBurst = parser.value(burstOption).toInt(&ok);
+    valid = valid && ok && limits.requestBurst >= 0;
+    limits.idleTimeoutMs = parser.value(idleTimeoutOption).toInt(&ok);
+    valid = valid && ok && limits.idleTimeoutMs >= 0;
+    limits.handshakeTimeoutMs = parser.value(handshakeTimeoutOption).toInt(&ok);
+    valid = valid && ok && limits.handshakeTimeoutMs >= 0;
+    
+    int stallThresholdMs = parser.value(stallOption).toInt(&ok);
+    valid = valid && ok && stallThresholdMs >= 0;
+    
+    if (!valid) {
+        qCritical() << "Неверные параметры ограничений: ожидаются неотрицательные числа";
+        return 1;
+    }
+    
+    if (parser.isSet(traceOption)) {
+        Tracer::instance().enableExport(parser.value(traceOption));
+    }
+    
+    EventLoopWatchdog watchdog;
+    watchdog.start(stallThresholdMs);
+    
     Server server;
+    server.setLimits(limits);
     if (!server.start(12345)) {
         return -1;
     }
     
+    // Локальный транспорт работает параллельно TCP; без него сервер продолжает работу
+    QString localName = parser.value(localOption);
+    if (!localName.isEmpty()) {
+        server.startLocal(localName);
+    }
+    
     return a.exec();
 } 
\ No newline at end of file
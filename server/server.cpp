@@ -8,10 +8,21 @@
 #include <QJsonArray>
 #include <QFile>
 #include <QCoreApplication>
+#include <QUrl>
+#include <QtMath>
+#include <QElapsedTimer>
+#include "fastxmlparser.h"
+#include "tracer.h"
 
 Server::Server(QObject *parent) : QObject(parent)
 {
     tcpServer = new QTcpServer(this);
+    localServer = new QLocalServer(this);
+    clock.start();
+
+    rateBucketTimer = new QTimer(this);
+    connect(rateBucketTimer, &QTimer::timeout, this, &Server::expireRateBuckets);
+    rateBucketTimer->start(RATE_BUCKET_EXPIRY_INTERVAL_MS);
     
     // Инициализация базы данных
     db = QSqlDatabase::addDatabase("QSQLITE");
@@ -47,6 +58,37 @@ bool Server::start(int port)
     return true;
 }
 
+bool Server::startLocal(const QString &name)
+{
+    // Удаляем файл сокета, оставшийся после аварийного завершения
+    QLocalServer::removeServer(name);
+
+    if (!localServer->listen(name)) {
+        qDebug() << "Локальный сервер не может запуститься. Ошибка:" << localServer->errorString();
+        return false;
+    }
+
+    connect(localServer, &QLocalServer::newConnection, this, &Server::handleNewLocalConnection);
+
+    qDebug() << "Локальный сервер запущен:" << localServer->fullServerName();
+    return true;
+}
+
+void Server::setLimits(const ServerLimits &limits)
+{
+    serverLimits = limits;
+}
+
+const ServerLimits &Server::limits() const
+{
+    return serverLimits;
+}
+
+const ServerStats &Server::stats() const
+{
+    return serverStats;
+}
+
 void Server::initDatabase()
 {
     if (!db.open()) {
@@ -65,34 +107,415 @@ void Server::initDatabase()
 
 void Server::handleNewConnection()
 {
-    QTcpSocket *clientSocket = tcpServer->nextPendingConnection();
-    connect(clientSocket, &QTcpSocket::readyRead, this, &Server::handleReadyRead);
-    connect(clientSocket, &QTcpSocket::disconnected, this, &Server::handleDisconnected);
-    
-    qDebug() << "Новое подключение от:" << clientSocket->peerAddress().toString();
+    while (tcpServer->hasPendingConnections()) {
+        QTcpSocket *clientSocket = tcpServer->nextPendingConnection();
+        QString peer = clientSocket->peerAddress().toString();
+
+        connect(clientSocket, &QTcpSocket::disconnected, this, &Server::handleDisconnected);
+        if (rejectIfFull(clientSocket, peer)) {
+            continue;
+        }
+        acceptClient(clientSocket, peer);
+    }
+}
+
+void Server::handleNewLocalConnection()
+{
+    while (localServer->hasPendingConnections()) {
+        QLocalSocket *clientSocket = localServer->nextPendingConnection();
+        // У локального сокета нет адреса; каждое подключение - отдельный узел,
+        // иначе все клиенты на этом узле делили бы одно ограничение по адресу
+        // и одну норму запросов. Их общее число ограничивает maxConnections.
+        QString peer = QString("local#%1").arg(++localConnectionCount);
+
+        connect(clientSocket, &QLocalSocket::disconnected, this, &Server::handleDisconnected);
+        if (rejectIfFull(clientSocket, peer)) {
+            continue;
+        }
+        acceptClient(clientSocket, peer);
+    }
+}
+
+bool Server::rejectIfFull(QIODevice *client, const QString &peer)
+{
+    const bool serverFull = serverLimits.maxConnections > 0 &&
+                            clients.size() >= serverLimits.maxConnections;
+    // Один адрес не должен занимать все подключения сервера
+    const bool peerFull = serverLimits.maxConnectionsPerPeer > 0 &&
+                          peerConnections.value(peer) >= serverLimits.maxConnectionsPerPeer;
+    if (!serverFull && !peerFull) {
+        return false;
+    }
+
+    // Вежливо отказываем и закрываем соединение после отправки сообщения
+    // в том же формате JSON, что и остальные ответы; сокет удалит handleDisconnected()
+    if (serverFull) {
+        ++serverStats.rejectedConnections;
+        qDebug() << "Превышено число подключений, отказ:" << peer;
+        client->write(errorToJson("too many connections, try again later"));
+    } else {
+        ++serverStats.rejectedPeerConnections;
+        qDebug() << "Превышено число подключений с адреса, отказ:" << peer;
+        client->write(errorToJson("too many connections from this address, try again later"));
+    }
+    if (QTcpSocket *tcpSocket = qobject_cast<QTcpSocket*>(client)) {
+        tcpSocket->disconnectFromHost();
+    } else if (QLocalSocket *localSocket = qobject_cast<QLocalSocket*>(client)) {
+        localSocket->disconnectFromServer();
+    }
+    logStats();
+    return true;
+}
+
+void Server::acceptClient(QIODevice *client, const QString &peer)
+{
+    ClientState state;
+    state.peer = peer;
+    state.timer = new QTimer(client);
+    state.timer->setSingleShot(true);
+    connect(state.timer, &QTimer::timeout, this, [this, client]() {
+        handleClientTimeout(client);
+    });
+    clients.insert(client, state);
+    ++peerConnections[peer];
+    restartClientTimer(state);
+
+    connect(client, &QIODevice::readyRead, this, &Server::handleReadyRead);
+    connect(client, &QIODevice::bytesWritten, this, &Server::handleBytesWritten);
+
+    ++serverStats.acceptedConnections;
+    qDebug() << "Новое подключение от:" << peer;
 }
 
 void Server::handleReadyRead()
 {
-    QTcpSocket *clientSocket = qobject_cast<QTcpSocket*>(sender());
+    TRACE_SPAN("Server::handleReadyRead");
+
+    QIODevice *clientSocket = qobject_cast<QIODevice*>(sender());
     if (!clientSocket) return;
 
-    QByteArray request = clientSocket->readAll();
-    qDebug() << "Получен запрос от клиента:" << request;
-    
-    // Отправляем данные клиенту
-    QByteArray jsonData = equipmentToJson();
-    qDebug() << "Отправляем клиенту данные:" << jsonData;
-    clientSocket->write(jsonData);
+    auto it = clients.find(clientSocket);
+    if (it == clients.end()) return;
+
+    it->inputBuffer += clientSocket->readAll();
+    // До первого распознанного запроса таймер рукопожатия не продлевается:
+    // иначе его сбрасывал бы любой мусорный байт
+    if (it->handshakeDone) {
+        restartClientTimer(*it);
+    }
+
+    // Запросы разделяются переводом строки
+    int newline;
+    while ((newline = it->inputBuffer.indexOf('\n')) >= 0) {
+        QByteArray line = it->inputBuffer.left(newline).trimmed();
+        it->inputBuffer.remove(0, newline + 1);
+
+        handleRequest(clientSocket, line);
+
+        // Обработка запроса может отключить клиента
+        it = clients.find(clientSocket);
+        if (it == clients.end()) return;
+    }
+
+    // Старые клиенты присылают GET_DATA без перевода строки
+    if (it->inputBuffer == "GET_DATA") {
+        it->inputBuffer.clear();
+        handleRequest(clientSocket, "GET_DATA");
+        return;
+    }
+
+    if (it->inputBuffer.size() > MAX_REQUEST_BYTES) {
+        ++serverStats.invalidRequests;
+        qDebug() << "Слишком длинный запрос, отключение:" << it->peer;
+        logStats();
+        abortClient(clientSocket);
+        removeClient(clientSocket);
+    }
+}
+
+void Server::handleRequest(QIODevice *client, const QByteArray &line)
+{
+    TRACE_SPAN("Server::handleRequest");
+
+    auto it = clients.find(client);
+    if (it == clients.end() || line.isEmpty()) return;
+
+    QStringList parts = QString::fromUtf8(line).split(' ', Qt::SkipEmptyParts);
+    QString command = parts.takeFirst();
+    for (QString &part : parts) {
+        part = decodeArgument(part);
+    }
+
+    const bool known = command == "GET_DATA" || command == "GET_BOARDS" || command == "GET_PORTS";
+    if (!it->handshakeDone && known) {
+        it->handshakeDone = true;
+        restartClientTimer(*it);
+    }
+
+    // Норму частоты расходует каждый запрос, иначе поток дешёвых или
+    // некорректных строк обходил бы ограничение
+    double cost = 1.0;
+    if (command == "GET_BOARDS") {
+        cost = LOOKUP_REQUEST_COST + LOOKUP_DEVICE_COST * parts.size();
+    } else if (command == "GET_PORTS") {
+        cost = LOOKUP_REQUEST_COST;
+    }
+
+    qint64 retryAfterMs = 0;
+    if (!acquireRequestToken(it->peer, cost, &retryAfterMs)) {
+        ++serverStats.rateLimitedRequests;
+        // Некорректные запросы сверх нормы отбрасываются молча
+        if (!known) {
+            return;
+        }
+        qDebug() << "Превышена частота запросов, запрос отклонён:" << it->peer << command;
+        // Без ответа клиент ждал бы данных до своего таймаута
+        writeToClient(client, errorToJson("rate limited", command, parts, retryAfterMs));
+        return;
+    }
+
+    if (command == "GET_DATA") {
+        qDebug() << "Получен запрос от клиента:" << command;
+
+        // Отправляем данные клиенту
+        sendDataToClient(client);
+    } else if (command == "GET_BOARDS" && !parts.isEmpty() && parts.size() <= MAX_BATCH_DEVICES) {
+        writeToClient(client, boardsToJson(parts));
+    } else if (command == "GET_PORTS" && parts.size() == 2) {
+        writeToClient(client, portsToJson(parts.at(0), parts.at(1)));
+    } else if (known) {
+        ++serverStats.invalidRequests;
+        qDebug() << "Некорректные аргументы запроса:" << it->peer << command;
+
+        // Аргументы возвращаются клиенту, чтобы он мог сбросить
+        // ожидание ответа на этот запрос
+        writeToClient(client, errorToJson("invalid arguments", command, parts));
+    } else {
+        // Содержимое неизвестной строки не выводится ни в журнал, ни в ответ
+        ++serverStats.invalidRequests;
+        qDebug() << "Неизвестный запрос от:" << it->peer;
+        writeToClient(client, errorToJson("unknown request"));
+    }
+}
+
+QByteArray Server::errorToJson(const QString &message, const QString &command, const QStringList &args,
+                               qint64 retryAfterMs)
+{
+    QJsonObject error;
+    error["type"] = "error";
+    error["message"] = message;
+    if (!command.isEmpty()) {
+        error["command"] = command;
+        error["args"] = QJsonArray::fromStringList(args);
+    }
+    if (retryAfterMs >= 0) {
+        error["retryAfterMs"] = retryAfterMs;
+    }
+    return QJsonDocument(error).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QString Server::decodeArgument(const QString &argument)
+{
+    // Клиент кодирует аргументы процентами, а пустое значение передаёт как "-"
+    if (argument == "-") {
+        return QString();
+    }
+    return QUrl::fromPercentEncoding(argument.toUtf8());
+}
+
+void Server::writeToClient(QIODevice *client, const QByteArray &data)
+{
+    auto it = clients.find(client);
+    if (it == clients.end()) return;
+
+    // Пока в буфере сокета выгрузка, небольшие ответы ждут в очереди за ней.
+    // Отключается только клиент, у которого переполнилась и сама очередь.
+    const qint64 pendingBytes = client->bytesToWrite();
+    if (serverLimits.maxPendingOutputBytes > 0 &&
+        (!it->outputQueue.isEmpty() ||
+         (pendingBytes > 0 && pendingBytes + data.size() > serverLimits.maxPendingOutputBytes))) {
+        if (it->queuedBytes + data.size() > serverLimits.maxPendingOutputBytes) {
+            ++serverStats.droppedSlowClients;
+            qDebug() << "Клиент не читает данные, отключение:" << it->peer;
+            logStats();
+            abortClient(client);
+            removeClient(client);
+            return;
+        }
+        it->outputQueue.append(data);
+        it->queuedBytes += data.size();
+        return;
+    }
+
+    client->write(data);
+}
+
+void Server::flushOutputQueue(QIODevice *client, ClientState &state)
+{
+    while (!state.outputQueue.isEmpty()) {
+        const qint64 pendingBytes = client->bytesToWrite();
+        if (pendingBytes > 0 &&
+            pendingBytes + state.outputQueue.first().size() > serverLimits.maxPendingOutputBytes) {
+            return;
+        }
+        QByteArray data = state.outputQueue.takeFirst();
+        state.queuedBytes -= data.size();
+        client->write(data);
+    }
+}
+
+void Server::handleBytesWritten()
+{
+    QIODevice *clientSocket = qobject_cast<QIODevice*>(sender());
+    if (!clientSocket) return;
+
+    auto it = clients.find(clientSocket);
+    if (it == clients.end()) return;
+
+    // Клиент читает данные - это тоже активность, но не рукопожатие
+    if (it->handshakeDone) {
+        restartClientTimer(*it);
+    }
+
+    // Сначала ответы, пришедшие раньше отложенной выгрузки
+    flushOutputQueue(clientSocket, *it);
+
+    if (it->responsePending && it->outputQueue.isEmpty() && clientSocket->bytesToWrite() == 0) {
+        sendDataToClient(clientSocket);
+    }
 }
 
 void Server::handleDisconnected()
 {
-    QTcpSocket *clientSocket = qobject_cast<QTcpSocket*>(sender());
-    if (clientSocket) {
-        qDebug() << "Клиент отключился:" << clientSocket->peerAddress().toString();
+    QIODevice *clientSocket = qobject_cast<QIODevice*>(sender());
+    if (!clientSocket) return;
+
+    auto it = clients.find(clientSocket);
+    if (it == clients.end()) {
+        // Соединение, которому было отказано в подключении
         clientSocket->deleteLater();
+        return;
+    }
+
+    qDebug() << "Клиент отключился:" << it->peer;
+    removeClient(clientSocket);
+}
+
+void Server::restartClientTimer(const ClientState &state)
+{
+    int timeoutMs = state.handshakeDone ? serverLimits.idleTimeoutMs
+                                        : serverLimits.handshakeTimeoutMs;
+    if (timeoutMs > 0) {
+        state.timer->start(timeoutMs);
+    } else {
+        state.timer->stop();
+    }
+}
+
+void Server::handleClientTimeout(QIODevice *client)
+{
+    auto it = clients.find(client);
+    if (it == clients.end()) return;
+
+    if (!it->handshakeDone) {
+        ++serverStats.handshakeTimeouts;
+        qDebug() << "Клиент не прислал запрос вовремя, отключение:" << it->peer;
+    } else if (client->bytesToWrite() > 0) {
+        ++serverStats.droppedSlowClients;
+        qDebug() << "Клиент не читает данные, отключение:" << it->peer;
+    } else {
+        ++serverStats.idleTimeouts;
+        qDebug() << "Клиент бездействует, отключение:" << it->peer;
+    }
+    logStats();
+
+    // abort() сбрасывает неотправленные данные и не ждёт клиента
+    abortClient(client);
+    removeClient(client);
+}
+
+void Server::abortClient(QIODevice *client)
+{
+    if (QTcpSocket *tcpSocket = qobject_cast<QTcpSocket*>(client)) {
+        tcpSocket->abort();
+    } else if (QLocalSocket *localSocket = qobject_cast<QLocalSocket*>(client)) {
+        localSocket->abort();
+    }
+}
+
+void Server::removeClient(QIODevice *client)
+{
+    auto it = clients.find(client);
+    if (it == clients.end()) return;
+
+    auto peerIt = peerConnections.find(it->peer);
+    if (peerIt != peerConnections.end() && --*peerIt <= 0) {
+        peerConnections.erase(peerIt);
     }
+
+    clients.erase(it);
+    client->deleteLater();
+}
+
+bool Server::acquireRequestToken(const QString &peer, double cost, qint64 *retryAfterMs)
+{
+    if (serverLimits.requestsPerSecond <= 0) {
+        return true;
+    }
+
+    const double burst = qMax(1, serverLimits.requestBurst);
+    const qint64 now = clock.elapsed();
+
+    auto it = rateBuckets.find(peer);
+    if (it == rateBuckets.end()) {
+        RateBucket bucket;
+        bucket.tokens = burst;
+        bucket.updatedMs = now;
+        it = rateBuckets.insert(peer, bucket);
+    }
+
+    // Token bucket: запас пополняется со скоростью requestsPerSecond до burst
+    it->tokens = qMin(burst, it->tokens + (now - it->updatedMs) * serverLimits.requestsPerSecond / 1000.0);
+    it->updatedMs = now;
+
+    if (it->tokens < cost) {
+        if (retryAfterMs) {
+            *retryAfterMs = qCeil((cost - it->tokens) * 1000.0 / serverLimits.requestsPerSecond);
+        }
+        return false;
+    }
+    it->tokens -= cost;
+    return true;
+}
+
+void Server::expireRateBuckets()
+{
+    // Полностью пополнившийся счётчик ничем не отличается от нового,
+    // поэтому его можно удалить, не ослабляя ограничение
+    const double burst = qMax(1, serverLimits.requestBurst);
+    const qint64 now = clock.elapsed();
+
+    for (auto it = rateBuckets.begin(); it != rateBuckets.end(); ) {
+        double tokens = it->tokens + (now - it->updatedMs) * serverLimits.requestsPerSecond / 1000.0;
+        if (serverLimits.requestsPerSecond <= 0 || tokens >= burst) {
+            it = rateBuckets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Server::logStats() const
+{
+    qDebug() << "Статистика: подключений" << serverStats.acceptedConnections
+             << "отказов" << serverStats.rejectedConnections
+             << "отказов по адресу" << serverStats.rejectedPeerConnections
+             << "отброшенных запросов" << serverStats.rateLimitedRequests
+             << "некорректных запросов" << serverStats.invalidRequests
+             << "отложенных ответов" << serverStats.deferredResponses
+             << "медленных клиентов" << serverStats.droppedSlowClients
+             << "таймаутов бездействия" << serverStats.idleTimeouts
+             << "таймаутов рукопожатия" << serverStats.handshakeTimeouts;
 }
 
 void Server::parseXmlFiles(const QString &directory)
@@ -109,15 +532,57 @@ void Server::parseXmlFiles(const QString &directory)
 
 void Server::parseXmlFile(const QString &filePath)
 {
+    TRACE_SPAN("Server::parseXmlFile");
+
     qDebug() << "Чтение XML файла:" << filePath;
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         qDebug() << "Не удалось открыть файл:" << filePath;
         return;
     }
 
-    QXmlStreamReader xml(&file);
-    Equipment equipment;
+    // Разбираем сразу в модель сервера; при ошибке запись удаляется
+    equipmentList.append(Equipment());
+    Equipment &equipment = equipmentList.last();
+
+    if (!parseXmlFast(file, equipment)) {
+        qDebug() << "Быстрый парсер не подошёл, используется QXmlStreamReader:" << filePath;
+        equipment = Equipment();
+        file.seek(0);
+
+        QString errorString;
+        if (!parseXmlWithReader(&file, equipment, &errorString)) {
+            qDebug() << "Ошибка парсинга XML:" << errorString;
+            equipmentList.removeLast();
+            return;
+        }
+    }
+
+    file.close();
+    equipmentIndex.insert(equipment.ip, equipmentList.size() - 1);
+    saveEquipmentToDb(equipment);
+}
+
+bool Server::parseXmlFast(QFile &file, Equipment &equipment)
+{
+    const qint64 size = file.size();
+    if (size <= 0) {
+        return false;
+    }
+
+    uchar *data = file.map(0, size);
+    if (!data) {
+        return false;
+    }
+
+    bool ok = FastXmlParser::parse(reinterpret_cast<const char *>(data), size, equipment);
+    file.unmap(data);
+    return ok;
+}
+
+bool Server::parseXmlWithReader(QIODevice *device, Equipment &equipment, QString *errorString)
+{
+    QXmlStreamReader xml(device);
 
     while (!xml.atEnd() && !xml.hasError()) {
         QXmlStreamReader::TokenType token = xml.readNext();
@@ -145,9 +610,9 @@ void Server::parseXmlFile(const QString &filePath)
                 board.intLinks = attrs.value("IntLinks").toString();
                 board.algorithms = attrs.value("Algoritms").toString();
                 
-                // Читаем порты платы
+                // Читаем порты платы; при ошибке readNext() больше не продвигается
                 while (!(xml.tokenType() == QXmlStreamReader::EndElement && 
-                        xml.name() == "board")) {
+                        xml.name() == "board") && !xml.atEnd() && !xml.hasError()) {
                     if (xml.tokenType() == QXmlStreamReader::StartElement && 
                         xml.name() == "port") {
                         Port port;
@@ -167,16 +632,171 @@ void Server::parseXmlFile(const QString &filePath)
     }
 
     if (xml.hasError()) {
-        qDebug() << "Ошибка парсинга XML:" << xml.errorString();
-        return;
+        if (errorString) {
+            *errorString = xml.errorString();
+        }
+        return false;
     }
 
-    file.close();
-    saveEquipmentToDb(equipment);
+    return true;
+}
+
+bool Server::verifyXmlParsers(const QString &directory)
+{
+    QDir dir(directory);
+    QStringList filters;
+    filters << "*.xml";
+    QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
+
+    if (files.isEmpty()) {
+        qDebug() << "XML файлы не найдены в каталоге:" << directory;
+        return false;
+    }
+
+    int fastCount = 0;
+    int mismatchCount = 0;
+    int unexpectedCount = 0;
+    qint64 fastNs = 0;
+    qint64 readerNs = 0;
+    QElapsedTimer timer;
+
+    for (const QFileInfo &fileInfo : files) {
+        QFile file(fileInfo.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            qDebug() << "Не удалось открыть файл:" << fileInfo.filePath();
+            continue;
+        }
+
+        Equipment fast;
+        timer.start();
+        bool fastOk = parseXmlFast(file, fast);
+        fastNs += timer.nsecsElapsed();
+
+        file.seek(0);
+        Equipment reference;
+        QString errorString;
+        timer.start();
+        bool readerOk = parseXmlWithReader(&file, reference, &errorString);
+        readerNs += timer.nsecsElapsed();
+
+        // Быстрый парсер вправе отказаться от файла, но не вправе разобрать его иначе
+        if (fastOk) {
+            ++fastCount;
+            if (!readerOk || fast != reference) {
+                ++mismatchCount;
+                qDebug() << "Результаты парсеров расходятся:" << fileInfo.filePath();
+            }
+        } else {
+            qDebug() << "Откат на QXmlStreamReader:" << fileInfo.fileName()
+                     << (readerOk ? QString("разобран") : "ошибка: " + errorString);
+        }
+
+        // Префикс имени задаёт ожидаемый путь разбора: fast-* обязан пройти
+        // быстрым парсером, fallback-* - уйти на QXmlStreamReader
+        const QString fileName = fileInfo.fileName();
+        if ((fileName.startsWith("fast-") && !fastOk) ||
+            (fileName.startsWith("fallback-") && fastOk)) {
+            ++unexpectedCount;
+            qDebug() << "Неожиданный путь разбора:" << fileInfo.filePath();
+        }
+    }
+
+    qDebug() << "Файлов:" << files.size()
+             << "быстрый парсер:" << fastCount
+             << "откат на QXmlStreamReader:" << files.size() - fastCount
+             << "расхождений:" << mismatchCount
+             << "неожиданных путей разбора:" << unexpectedCount;
+    qDebug() << "Время быстрого парсера, мс:" << fastNs / 1000000.0
+             << "QXmlStreamReader, мс:" << readerNs / 1000000.0;
+    if (fastNs > 0) {
+        qDebug() << "Ускорение:" << double(readerNs) / double(fastNs);
+    }
+
+    return mismatchCount == 0 && unexpectedCount == 0;
+}
+
+bool Server::generateXmlCorpus(const QString &directory, int count)
+{
+    if (!QDir().mkpath(directory)) {
+        qDebug() << "Не удалось создать каталог:" << directory;
+        return false;
+    }
+
+    qint64 totalBytes = 0;
+    for (int i = 0; i < count; ++i) {
+        QString filePath = QString("%1/fast-synthetic-%2.xml").arg(directory).arg(i, 6, 10, QChar('0'));
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "Не удалось создать файл:" << filePath;
+            return false;
+        }
+        QByteArray data = syntheticDeviceXml(i);
+        file.write(data);
+        totalBytes += data.size();
+    }
+
+    qDebug() << "Создано файлов:" << count << "байт:" << totalBytes;
+    return true;
+}
+
+QByteArray Server::syntheticDeviceXml(int index)
+{
+    // Содержимое детерминировано индексом, чтобы замеры были воспроизводимы.
+    // Часть файлов использует CRLF, комментарии и одинарные кавычки -
+    // конструкции, которые быстрый парсер обязан принимать.
+    const QByteArray nl = index % 7 == 3 ? "\r\n" : "\n";
+    const char quote = index % 5 == 2 ? '\'' : '"';
+    const QByteArray n = QByteArray::number(index);
+    const int boardCount = 1 + index % 8;
+
+    auto attr = [quote](const char *name, const QByteArray &value) {
+        return QByteArray(" ") + name + "=" + quote + value + quote;
+    };
+
+    QByteArray xml;
+    xml.reserve(512 + boardCount * 1024);
+    xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" + nl;
+    if (index % 10 == 0) {
+        xml += "<!-- синтетическое устройство " + n + " -->" + nl;
+    }
+    xml += "<device>" + nl;
+    xml += "    <block" + attr("id", n)
+         + attr("Name", "Устройство " + n)
+         + attr("IP", "10." + QByteArray::number((index >> 16) & 255) + "." +
+                QByteArray::number((index >> 8) & 255) + "." + QByteArray::number(index & 255))
+         + attr("BoardCount", QByteArray::number(boardCount))
+         + attr("MtR", QByteArray::number(index % 4))
+         + attr("MtC", QByteArray::number(index % 3))
+         + attr("Description", "Синтетическое устройство номер " + n)
+         + attr("Label", "SYNTH-" + n) + ">" + nl;
+
+    for (int b = 1; b <= boardCount; ++b) {
+        const QByteArray boardId = "b" + n + "_" + QByteArray::number(b);
+        const int portCount = 4 + (index + b) % 13;
+        xml += "        <board" + attr("id", boardId)
+             + attr("Num", QByteArray::number(b))
+             + attr("Name", "Плата " + QByteArray::number(b))
+             + attr("PortCount", QByteArray::number(portCount))
+             + attr("IntLinks", "")
+             + attr("Algoritms", "") + ">" + nl;
+        for (int p = 1; p <= portCount; ++p) {
+            xml += "            <port" + attr("id", "p" + n + "_" + QByteArray::number(b) + "_" + QByteArray::number(p))
+                 + attr("Num", QByteArray::number(p))
+                 + attr("Media", QByteArray::number(p % 3))
+                 + attr("Signal", QByteArray::number((index + p) % 5)) + "/>" + nl;
+        }
+        xml += "        </board>" + nl;
+    }
+
+    xml += "    </block>" + nl;
+    xml += "</device>" + nl;
+    return xml;
 }
 
 void Server::saveEquipmentToDb(const Equipment &equipment)
 {
+    TRACE_SPAN("Server::saveEquipmentToDb");
+
     qDebug() << "Сохранение в БД оборудования с IP:" << equipment.ip;
     QSqlQuery query;
     
@@ -187,6 +807,8 @@ void Server::saveEquipmentToDb(const Equipment &equipment)
     query.bindValue(":name", equipment.name);
     query.bindValue(":description", equipment.description);
     
+    snapshotValid = false;
+
     if (!query.exec()) {
         qDebug() << "Ошибка сохранения в БД:" << query.lastError().text();
     } else {
@@ -194,14 +816,123 @@ void Server::saveEquipmentToDb(const Equipment &equipment)
     }
 }
 
-void Server::sendDataToClient(QTcpSocket *client)
+void Server::sendDataToClient(QIODevice *client)
 {
-    QByteArray jsonData = equipmentToJson();
+    auto it = clients.find(client);
+    if (it == clients.end()) return;
+
+    const QByteArray &jsonData = snapshot();
+
+    // Если клиент не успевает читать, не копим ответы в буфере сокета:
+    // откладываем один ответ до освобождения буфера и очереди (handleBytesWritten)
+    const qint64 pendingBytes = client->bytesToWrite();
+    if (serverLimits.maxPendingOutputBytes > 0 &&
+        (!it->outputQueue.isEmpty() ||
+         (pendingBytes > 0 && pendingBytes + jsonData.size() > serverLimits.maxPendingOutputBytes))) {
+        if (!it->responsePending) {
+            it->responsePending = true;
+            ++serverStats.deferredResponses;
+            qDebug() << "Буфер клиента переполнен, ответ отложен:" << it->peer;
+        }
+        return;
+    }
+
+    it->responsePending = false;
+    qDebug() << "Отправляем клиенту данные, байт:" << jsonData.size();
     client->write(jsonData);
 }
 
+const QByteArray &Server::snapshot()
+{
+    // Один и тот же неявно разделяемый буфер уходит всем клиентам
+    // независимо от транспорта; пересобирается после изменения данных
+    if (!snapshotValid) {
+        snapshotData = equipmentToJson();
+        snapshotValid = true;
+    }
+    return snapshotData;
+}
+
+const Equipment *Server::findEquipment(const QString &ip) const
+{
+    auto it = equipmentIndex.constFind(ip);
+    if (it == equipmentIndex.constEnd()) {
+        return nullptr;
+    }
+    return &equipmentList.at(it.value());
+}
+
+QByteArray Server::boardsToJson(const QStringList &ips) const
+{
+    QJsonArray devicesArray;
+
+    for (const QString &ip : ips) {
+        QJsonObject deviceObject;
+        deviceObject["ip"] = ip;
+
+        const Equipment *equipment = findEquipment(ip);
+        deviceObject["found"] = equipment != nullptr;
+
+        QJsonArray boardsArray;
+        if (equipment) {
+            for (const Board &board : equipment->boards) {
+                QJsonObject boardObject;
+                boardObject["id"] = board.id;
+                boardObject["num"] = board.num;
+                boardObject["name"] = board.name;
+                boardObject["portCount"] = board.portCount;
+                boardObject["intLinks"] = board.intLinks;
+                boardObject["algorithms"] = board.algorithms;
+                boardsArray.append(boardObject);
+            }
+        }
+        deviceObject["boards"] = boardsArray;
+        devicesArray.append(deviceObject);
+    }
+
+    QJsonObject response;
+    response["type"] = "boards";
+    response["devices"] = devicesArray;
+    return QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray Server::portsToJson(const QString &ip, const QString &boardId) const
+{
+    const Board *board = nullptr;
+    if (const Equipment *equipment = findEquipment(ip)) {
+        for (const Board &candidate : equipment->boards) {
+            if (candidate.id == boardId) {
+                board = &candidate;
+                break;
+            }
+        }
+    }
+
+    QJsonArray portsArray;
+    if (board) {
+        for (const Port &port : board->ports) {
+            QJsonObject portObject;
+            portObject["id"] = port.id;
+            portObject["num"] = port.num;
+            portObject["media"] = port.media;
+            portObject["signal"] = port.signal;
+            portsArray.append(portObject);
+        }
+    }
+
+    QJsonObject response;
+    response["type"] = "ports";
+    response["ip"] = ip;
+    response["board"] = boardId;
+    response["found"] = board != nullptr;
+    response["ports"] = portsArray;
+    return QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n';
+}
+
 QByteArray Server::equipmentToJson() const
 {
+    TRACE_SPAN("Server::equipmentToJson");
+
     QJsonArray equipmentArray;
     QSqlQuery query("SELECT * FROM equipment");
     
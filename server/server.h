@@ -4,36 +4,37 @@
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include <QSqlDatabase>
 #include <QXmlStreamReader>
+#include <QFile>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "equipment.h"
 
-struct Port {
-    QString id;
-    int num;
-    int media;
-    int signal;
+// Ограничения на подключения; нулевое значение отключает соответствующую проверку
+struct ServerLimits {
+    int maxConnections = 100;
+    int maxConnectionsPerPeer = 10;
+    qint64 maxPendingOutputBytes = 16 * 1024 * 1024;
+    double requestsPerSecond = 5.0;
+    int requestBurst = 10;
+    int idleTimeoutMs = 600000;
+    int handshakeTimeoutMs = 10000;
 };
 
-struct Board {
-    QString id;
-    int num;
-    QString name;
-    int portCount;
-    QString intLinks;
-    QString algorithms;
-    QList<Port> ports;
-};
-
-struct Equipment {
-    QString blockId;
-    QString name;
-    QString ip;
-    int boardCount;
-    int mtR;
-    int mtC;
-    QString description;
-    QString label;
-    QList<Board> boards;
+struct ServerStats {
+    quint64 acceptedConnections = 0;
+    quint64 rejectedConnections = 0;
+    quint64 rejectedPeerConnections = 0;
+    quint64 rateLimitedRequests = 0;
+    quint64 invalidRequests = 0;
+    quint64 deferredResponses = 0;
+    quint64 droppedSlowClients = 0;
+    quint64 idleTimeouts = 0;
+    quint64 handshakeTimeouts = 0;
 };
 
 class Server : public QObject
@@ -42,23 +43,101 @@ class Server : public QObject
 public:
     explicit Server(QObject *parent = nullptr);
     bool start(int port = 12345);
+    bool startLocal(const QString &name);
+
+    void setLimits(const ServerLimits &limits);
+    const ServerLimits &limits() const;
+    const ServerStats &stats() const;
+
+    // Сверка быстрого парсера с QXmlStreamReader на всех XML файлах каталога
+    static bool verifyXmlParsers(const QString &directory);
+    // Генерация синтетического набора XML файлов для сверки и замера парсеров
+    static bool generateXmlCorpus(const QString &directory, int count);
 
 private slots:
     void handleNewConnection();
+    void handleNewLocalConnection();
     void handleReadyRead();
     void handleDisconnected();
+    void handleBytesWritten();
+    void expireRateBuckets();
 
 private:
+    struct ClientState {
+        QTimer *timer = nullptr;
+        QString peer;
+        bool handshakeDone = false;
+        bool responsePending = false;
+        QByteArray inputBuffer;
+        // Небольшие ответы, ожидающие, пока уйдёт выгрузка из буфера сокета
+        QList<QByteArray> outputQueue;
+        qint64 queuedBytes = 0;
+    };
+
+    struct RateBucket {
+        double tokens = 0;
+        qint64 updatedMs = 0;
+    };
+
+    void handleRequest(QIODevice *client, const QByteArray &line);
+    static QString decodeArgument(const QString &argument);
+    static QByteArray errorToJson(const QString &message, const QString &command = QString(),
+                                  const QStringList &args = QStringList(), qint64 retryAfterMs = -1);
+    void writeToClient(QIODevice *client, const QByteArray &data);
+    void flushOutputQueue(QIODevice *client, ClientState &state);
+    void acceptClient(QIODevice *client, const QString &peer);
+    bool rejectIfFull(QIODevice *client, const QString &peer);
+    void restartClientTimer(const ClientState &state);
+    void handleClientTimeout(QIODevice *client);
+    void removeClient(QIODevice *client);
+    static void abortClient(QIODevice *client);
+    bool acquireRequestToken(const QString &peer, double cost, qint64 *retryAfterMs = nullptr);
+    void logStats() const;
+
     void parseXmlFiles(const QString &directory);
     void initDatabase();
-    void sendDataToClient(QTcpSocket *client);
+    void sendDataToClient(QIODevice *client);
     QList<Equipment> equipmentList;
+    // Индекс оборудования по IP; как и в БД, последний файл с тем же IP побеждает
+    QHash<QString, int> equipmentIndex;
     void parseXmlFile(const QString &filePath);
+    static bool parseXmlFast(QFile &file, Equipment &equipment);
+    static bool parseXmlWithReader(QIODevice *device, Equipment &equipment, QString *errorString);
+    static QByteArray syntheticDeviceXml(int index);
     void saveEquipmentToDb(const Equipment &equipment);
     QByteArray equipmentToJson() const;
+    QByteArray boardsToJson(const QStringList &ips) const;
+    QByteArray portsToJson(const QString &ip, const QString &boardId) const;
+    const Equipment *findEquipment(const QString &ip) const;
+    const QByteArray &snapshot();
 
     QTcpServer *tcpServer;
+    QLocalServer *localServer;
     QSqlDatabase db;
+
+    ServerLimits serverLimits;
+    ServerStats serverStats;
+    QHash<QIODevice*, ClientState> clients;
+    QHash<QString, int> peerConnections;
+    quint64 localConnectionCount = 0;
+    // Счётчики частоты запросов переживают отключение клиента, иначе
+    // переподключение сбрасывало бы ограничение
+    QHash<QString, RateBucket> rateBuckets;
+    QTimer *rateBucketTimer;
+    QElapsedTimer clock;
+
+    // Сериализованный JSON, общий для TCP и локальных клиентов
+    QByteArray snapshotData;
+    bool snapshotValid = false;
+
+    // Константы протокола
+    static const int MAX_REQUEST_BYTES = 4096;
+    static const int MAX_BATCH_DEVICES = 64;
+    static const int RATE_BUCKET_EXPIRY_INTERVAL_MS = 60000;
+    // Стоимость запросов в единицах нормы частоты: полная выгрузка и
+    // некорректный запрос - 1, поиск плат и портов - дешевле
+    static constexpr double LOOKUP_REQUEST_COST = 0.1;
+    static constexpr double LOOKUP_DEVICE_COST = 0.01;
 };
 
 #endif // SERVER_H 
\ No newline at end of file
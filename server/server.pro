@@ -3,7 +3,16 @@ CONFIG   += c++17
 TARGET    = server
 TEMPLATE  = app
 
+INCLUDEPATH += ../common
+
 SOURCES += main.cpp \
-           server.cpp
+           server.cpp \
+           fastxmlparser.cpp \
+           ../common/tracer.cpp \
+           ../common/eventloopwatchdog.cpp
 
-HEADERS += server.h 
\ No newline at end of file
+HEADERS += server.h \
+           equipment.h \
+           fastxmlparser.h \
+           ../common/tracer.h \
+           ../common/eventloopwatchdog.h 
\ No newline at end of file